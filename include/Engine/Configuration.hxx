@@ -8,6 +8,40 @@
  */
 constexpr unsigned int GRID_SIZE = 16;
 
+/**
+ * @brief Constants defining the rate of the simulation (in ticks per second).
+ *
+ * The simulation runs at a fixed rate, independent of the framerate. The rate is read from the settings, and kept
+ * between `MIN_TICK_RATE` and `MAX_TICK_RATE`.
+ */
+constexpr unsigned int DEFAULT_TICK_RATE = 30;
+constexpr unsigned int MIN_TICK_RATE = 20;
+constexpr unsigned int MAX_TICK_RATE = 60;
+
+/**
+ * @brief Constants defining the memory the resident chunks of the map should stay within (in MiB).
+ *
+ * The budget is read from the settings, and kept between `MIN_CHUNK_MEMORY_BUDGET` and `MAX_CHUNK_MEMORY_BUDGET`.
+ */
+constexpr unsigned int DEFAULT_CHUNK_MEMORY_BUDGET = 256;
+constexpr unsigned int MIN_CHUNK_MEMORY_BUDGET = 64;
+constexpr unsigned int MAX_CHUNK_MEMORY_BUDGET = 16384;
+
+/**
+ * @brief Constant defining the most simulation ticks run in a single frame to catch up with the elapsed time.
+ *
+ * Past this, the remaining time is dropped and the simulation runs slower than real time, instead of spending every
+ * later frame on more and more ticks to catch up (the spiral of death).
+ */
+constexpr unsigned int MAX_TICKS_PER_FRAME = 5;
+
+/**
+ * @brief Constant defining the longest frame time accounted for (in seconds).
+ *
+ * Longer frames, such as when the window is being dragged, count as this long.
+ */
+constexpr float MAX_FRAME_TIME = .25f;
+
 /**
  * @brief Defines the version of the game.
  *
@@ -119,3 +153,13 @@ constexpr unsigned int GRID_SIZE = 16;
 #ifndef LOCALES_FOLDER
 #define LOCALES_FOLDER static_cast<const std::string>(GLOBAL_FOLDER + "Locales/")
 #endif
+
+/**
+ * @brief Defines the folder path for storing profiler traces.
+ *
+ * The `TRACES_FOLDER` defines the directory path where the traces exported by the frame profiler will be stored.
+ * This is based on the `GLOBAL_FOLDER` path, which is platform-dependent.
+ */
+#ifndef TRACES_FOLDER
+#define TRACES_FOLDER static_cast<const std::string>(GLOBAL_FOLDER + "Traces/")
+#endif
@@ -15,6 +15,7 @@
 #include "Tools/Assert.hxx"
 #include "Tools/JSON.hxx"
 #include "Tools/Logger.hxx"
+#include "Tools/Profiler.hxx"
 #include "Tools/UUID.hxx"
 #include "Tools/Zip.hxx"
 
@@ -36,6 +37,8 @@ class Engine
 
     float dt;              ///< Delta time for frame updates.
     sf::Clock dtClock;     ///< Clock to measure delta time.
+    float tickDt;          ///< Duration of a simulation tick (in seconds).
+    float tickAccumulator; ///< Elapsed time not simulated yet (in seconds).
     unsigned int gridSize; ///< Size of the grid.
     unsigned int scale;    ///< Scale factor for rendering.
 
@@ -100,6 +103,12 @@ class Engine
      */
     void updateDeltaTime();
 
+    /**
+     * @brief Runs the simulation ticks covering the time elapsed since the last ones, at most `MAX_TICKS_PER_FRAME`,
+     * and stores how far the frame is into the next tick.
+     */
+    void updateSimulation();
+
     /**
      * @brief Updates the engine state.
      */
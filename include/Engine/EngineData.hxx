@@ -32,4 +32,6 @@ struct EngineData
     std::optional<sf::Event> event;                               ///< Window events.
     std::optional<sf::Event::MouseWheelScrolled> mouseData;       ///< Mouse scroll data if avaliable.
     GraphicsSettings *gfx;
+    float tickDt;        ///< Duration of a simulation tick (in seconds).
+    float interpolation; ///< How far the current frame is into the next simulation tick, from 0 to 1.
 };
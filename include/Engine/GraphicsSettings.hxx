@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include "Engine/Configuration.hxx"
 #include "Tools/JSON.hxx"
 #include "Tools/Logger.hxx"
 
@@ -26,6 +27,8 @@ class GraphicsSettings
     bool fontSmoothness;         ///< Flag to determine if font smoothness should be enabled.
     bool textureSmoothness;      ///< Flag to determine if texture smoothness should be enabled.
     std::string resourcePack;    ///< Name of the active resource pack.
+    unsigned int tickRate;       ///< Rate of the simulation (in ticks per second).
+    unsigned int memoryBudget;   ///< Memory the resident chunks of the map should stay within (in MiB).
 
     /**
      * @brief Constructs a GraphicsSettings instance.
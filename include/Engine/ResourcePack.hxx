@@ -7,6 +7,7 @@
 
 #include "Engine/Configuration.hxx"
 #include "Engine/Languages.hxx"
+#include "Map/BiomeRules.hxx"
 #include "Tiles/TileDatabase.hxx"
 #include "Tools/JSON.hxx"
 #include "Tools/Logger.hxx"
@@ -45,6 +46,17 @@ class ResourcePack
     std::unordered_map<std::string, std::shared_ptr<sf::Sound>> globalSounds; ///< Sounds that are preloaded by default.
     std::unordered_map<std::string, std::shared_ptr<sf::Music>> musics;       ///< Loaded musics.
     TileDatabase tileDb;                                                      ///< Tile database.
+    BiomeRules biomeRules;                                                    ///< Generation rules of the biomes.
+
+    /**
+     * @brief Loads only the data of the resource pack (its description, tile database and biome rules).
+     *
+     * No font, texture nor sound is touched, so this works without a window or an audio device (e.g. in tools).
+     *
+     * @param filename Filename of the resource pack to load.
+     * @return True if the data was successfully loaded, false otherwise.
+     */
+    const bool loadData(const std::string &filename);
 
     /**
      * @brief Loads the resource pack by filename.
@@ -53,6 +53,7 @@ class Entity
     uint64_t id;      ///< Unique session identifier for the entity.
 
     sf::Vector2f spawnGridPosition; ///< Spawn position of the entity in grid coordinates.
+    sf::Vector2f previousPosition;  ///< Position of the entity before the last simulation tick.
 
     sf::Texture &spriteSheet; ///< Reference to the sprite sheet texture used by the entity.
     float scale;              ///< Scaling factor for the entity's sprites.
@@ -147,9 +148,24 @@ class Entity
      */
     virtual void render(sf::RenderTarget &target, const bool &show_hitboxes) = 0;
 
+    /**
+     * @brief Renders the entity between its positions before and after the last simulation tick, so it moves smoothly
+     * at any framerate.
+     * @param target Render target to draw the entity on.
+     * @param show_hitboxes Whether to render hitboxes.
+     * @param interpolation How far the frame is into the next simulation tick, from 0 to 1.
+     */
+    void renderInterpolated(sf::RenderTarget &target, const bool &show_hitboxes, const float &interpolation);
+
+    /**
+     * @brief Stores the current position as the one before the next simulation tick. Called at the start of every
+     * tick.
+     */
+    void storePreviousPosition();
+
     /**
      * @brief Moves the entity in the specified direction.
-     * @param dt Delta time for frame-independent movement.
+     * @param dt Duration of the simulation tick.
      * @param direction Direction to move in.
      */
     void move(const float &dt, const MovementDirection &direction);
@@ -190,6 +206,14 @@ class Entity
      */
     const sf::Vector2f getPosition() const;
 
+    /**
+     * @brief Gets the position of the base sprite of the entity, between its positions before and after the last
+     * simulation tick. Rounded to whole pixels.
+     * @param interpolation How far the frame is into the next simulation tick, from 0 to 1.
+     * @return Interpolated position of the base sprite of the entity.
+     */
+    const sf::Vector2f getInterpolatedPosition(const float &interpolation) const;
+
     /**
      * @brief Gets the current size of the the base sprite of the entity.
      * @return Current size of the base sprite of the entity.
@@ -88,8 +88,8 @@ class MovementFunctionality
     void update();
 
     /**
-     * @brief Moves the entity in the specified direction.
-     * @param dt Delta time for frame-independent movement.
+     * @brief Moves the entity in the specified direction, by its velocity over a simulation tick.
+     * @param dt Duration of the simulation tick.
      * @param direction Direction to move in.
      */
     void move(const float &dt, const uint8_t direction);
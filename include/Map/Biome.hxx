@@ -26,6 +26,17 @@ enum BiomeType
     Tundra,           ///< Tundra biome type.
 };
 
+/**
+ * @typedef BiomeId
+ * @brief Compact biome identifier stored per tile column: the value of its `BiomeType`.
+ */
+using BiomeId = uint8_t;
+
+/**
+ * @brief The amount of biome types, "unknown" included. Biome IDs range from 0 to this value (excluded).
+ */
+static constexpr BiomeId BIOME_TYPE_COUNT = BiomeType::Tundra + 1;
+
 /**
  * @struct BiomePreset
  * @brief Struct representing the preset configuration for a biome.
@@ -38,6 +49,7 @@ struct BiomePreset
     BiomeType type = BiomeType::UnknownBiome; ///< Type of the biome (from BiomeType enum).
     sf::Color color = sf::Color::White;       ///< Color representation of the biome.
     std::string baseTileTag = "unknown";      ///< Base tile tag associated with the biome.
+    const TileData *baseTile = nullptr;       ///< Base tile, resolved from the tag once.
 };
 
 /**
@@ -0,0 +1,96 @@
+/**
+ * @file BiomeRules.hxx
+ * @brief Declares the BiomeRules class to hold the data-driven generation rules of every biome.
+ */
+
+#pragma once
+
+#include "Engine/Languages.hxx"
+#include "Map/Biome.hxx"
+#include "Tools/JSON.hxx"
+#include "Tools/Logger.hxx"
+
+/**
+ * @brief The name of the file holding the biome rules, at the root of a resource pack.
+ */
+static const std::string BIOME_RULES_FILENAME = "biomes.json";
+
+/**
+ * @struct DecorationRule
+ * @brief A tile that may be placed on top of the base tile of a biome.
+ */
+struct DecorationRule
+{
+    std::string tileTag; ///< Tag of the decoration tile.
+    float probability;   ///< Chance for a column of the biome to get this decoration, from 0 to 1.
+    uint8_t z;           ///< Layer the decoration is placed on.
+};
+
+/**
+ * @struct BiomeRule
+ * @brief The tiles a biome is made of.
+ */
+struct BiomeRule
+{
+    std::string baseTileTag = "unknown";     ///< Tag of the tile covering the ground of the biome.
+    std::vector<DecorationRule> decorations; ///< Decorations of the biome, at most one per column.
+};
+
+/**
+ * @class BiomeRules
+ * @brief The generation rules of every biome, as loaded from the `biomes.json` file of a resource pack.
+ *
+ * The file holds an array of objects, one per biome:
+ * `{"biome": "forest", "baseTile": "pixelminer:grass_tile", "decorations": [{"tile": "...", "probability": .001,
+ * "z": 1}]}`. Decorations of a biome are mutually exclusive: their probabilities add up, and the first one that
+ * matches a column's random value is placed.
+ *
+ * Rules are kept as tags here. The terrain generator resolves them against the tile database once, when it starts.
+ */
+class BiomeRules
+{
+  private:
+    Logger logger; ///< Logger for logging information and errors.
+
+    std::array<BiomeRule, BIOME_TYPE_COUNT> rules; ///< Rules of every biome, indexed by biome ID.
+
+    /**
+     * @brief Resets every rule to the built-in rules of the vanilla pack.
+     */
+    void setDefaults();
+
+    /**
+     * @brief Gets a biome type from its key in the rules file.
+     *
+     * @param key The key of the biome (e.g. "forest").
+     * @return The biome type, or `UnknownBiome` if the key is unknown.
+     */
+    static const BiomeType getTypeByKey(const std::string &key);
+
+  public:
+    /**
+     * @brief Constructs BiomeRules holding the built-in rules of the vanilla pack.
+     */
+    BiomeRules();
+
+    /**
+     * @brief Destructor for the BiomeRules class.
+     */
+    ~BiomeRules();
+
+    /**
+     * @brief Loads the rules from a file. Biomes the file doesn't mention keep their built-in rules.
+     *
+     * @param path The path to the rules file.
+     * @return `true` if the rules were loaded, `false` otherwise. The built-in rules are kept on failure.
+     */
+    const bool load(const std::filesystem::path &path);
+
+    /**
+     * @brief Gets the rules of a biome.
+     *
+     * @param biome_id The ID of the biome.
+     * @return The rules of the biome, or the ones of the unknown biome if the ID is out of range.
+     */
+    const BiomeRule &get(const BiomeId &biome_id) const;
+};
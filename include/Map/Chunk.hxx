@@ -5,6 +5,8 @@
 
 #pragma once
 
+#include "Map/ChunkConstants.hxx"
+#include "Map/ChunkMesh.hxx"
 #include "Tiles/Tile.hxx"
 
 /**
@@ -21,52 +23,138 @@ enum ChunkFlags : uint8_t
 };
 
 /**
- * @brief The size of a region in chunks (8x8 chunks).
+ * @enum ChunkStatus
+ * @brief How far a chunk went through the terrain generation pipeline. Stages always run in this order.
  */
-static constexpr sf::Vector2u REGION_SIZE_IN_CHUNKS = {8, 8};
+enum class ChunkStatus : uint8_t
+{
+    Empty,     ///< Nothing was generated yet.
+    Climate,   ///< Noise and biomes are known for every column.
+    Surface,   ///< Base tiles are placed. The chunk is playable.
+    Decorated, ///< Decorations (grass, bushes, snow) are placed on top of the surface.
+    Complete,  ///< Every stage ran and the mesh reflects it. Chunks loaded from disk start here.
+};
 
 /**
- * @brief The size of a chunk in tiles (16x16x5 tiles).
+ * @typedef TileCells
+ * @brief A dense array of palette indices, one per cell of a chunk.
+ *
+ * Cells are laid out layer by layer (z-major, then y, then x), so iterating the array in order visits the layers
+ * from the bottom to the top. Empty cells hold `EMPTY_CELL`.
  */
-static constexpr sf::Vector3<unsigned int> CHUNK_SIZE_IN_TILES = {16, 16, 5};
+using TileCells = std::array<uint16_t, CHUNK_VOLUME>;
 
 /**
- * @typedef TileMatrix
- * @brief A 3D array representing a chunk's grid of tiles.
- *
- * This type alias defines a 3D array of `Tile` objects, with dimensions defined by `CHUNK_SIZE_IN_TILES`.
- * Each element in the array is a `std::unique_ptr` to a `Tile` object.
+ * @struct ChunkMeshSnapshot
+ * @brief A copy of what building the mesh of a chunk needs, so a worker can build it without holding any lock.
+ */
+struct ChunkMeshSnapshot
+{
+    sf::Vector2i chunkIndex;                 ///< The index of the chunk.
+    float scale;                             ///< The scaling factor of the chunk.
+    std::vector<const TileData *> palette;   ///< The palette of the chunk.
+    TileCells cells;                         ///< The palette index of every cell.
+    std::array<sf::Color, CHUNK_AREA> tints; ///< The tint of every column.
+    std::vector<uint16_t> dirtyList;         ///< The cells whose quad is out of date in `base`.
+    const ChunkMesh *base;                   ///< The drawn mesh of the chunk, which the dirty cells are patched into.
+    uint64_t meshVersion;                    ///< The mesh version of the chunk the snapshot was taken at.
+};
+
+/**
+ * @struct ChunkSaveSnapshot
+ * @brief A copy of the cells of a chunk, so a worker can pack them without holding any lock.
  */
-using TileMatrix =
-    std::array<std::array<std::array<std::unique_ptr<Tile>, CHUNK_SIZE_IN_TILES.z>, CHUNK_SIZE_IN_TILES.y>,
-               CHUNK_SIZE_IN_TILES.x>;
+struct ChunkSaveSnapshot
+{
+    sf::Vector2i chunkIndex;               ///< The index of the chunk.
+    uint8_t flags;                         ///< The flags of the chunk (from ChunkFlags enum).
+    std::vector<const TileData *> palette; ///< The palette of the chunk.
+    TileCells cells;                       ///< The palette index of every cell.
+};
 
 /**
  * @class Chunk
  * @brief Represents a chunk of tiles within a larger map.
  *
- * A chunk is a portion of the map consisting of a grid of tiles. The chunk is characterized by its size,
- * position, and state flags. It can be rendered and updated as part of the map.
+ * A chunk is a portion of the map consisting of a grid of tiles. Tiles are stored as a per-chunk palette of the
+ * tile types in use plus a dense cell array of palette indices, and tints are stored once per column. `Tile`
+ * objects are only created as views when a cell is queried.
  */
 class Chunk : public sf::Drawable, public sf::Transformable
 {
   private:
     sf::Texture &texturePack;
 
+    std::vector<const TileData *> palette;   ///< Tile types used by the chunk. Cells index into this vector.
+    std::vector<uint16_t> paletteRefs;       ///< How many cells reference each palette entry.
+    TileCells cells;                         ///< Palette index of every cell, or `EMPTY_CELL`.
+    std::array<sf::Color, CHUNK_AREA> tints; ///< Tint of every tile column.
+
+    ChunkMesh mesh;                          ///< The drawn quads of the chunk.
+    std::bitset<CHUNK_VOLUME> dirtyCells;    ///< Cells whose quad is out of date.
+    std::vector<uint16_t> dirtyList;         ///< Indices of the dirty cells, in the order they were marked.
+    std::vector<uint16_t> buildingList;      ///< Cells handed to a mesh build that was not swapped in yet.
+    uint64_t meshVersion;                    ///< Changes whenever a snapshot is taken or the mesh is patched in place.
+
+    static std::atomic<uint64_t> nextMeshVersion; ///< Mesh versions are unique across chunks, so a build taken from
+                                                  ///< a chunk is never swapped into a copy of it.
+    unsigned int batchDepth;                 ///< How many batches are currently open on the chunk.
+
+    uint64_t epoch;      ///< Incremented on every change to the cells.
+    uint64_t savedEpoch; ///< The epoch of the cells last written to disk (or freshly generated).
+
+    ChunkStatus status; ///< How far the chunk went through terrain generation.
+
     void draw(sf::RenderTarget &target, sf::RenderStates states = sf::RenderStates::Default) const override;
 
+    /**
+     * @brief Finds or inserts a tile type in the palette.
+     *
+     * @param data The tile type.
+     * @return The palette index of the tile type.
+     */
+    const uint16_t acquirePaletteIndex(const TileData &data);
+
+    /**
+     * @brief Drops a cell reference to a palette entry, freeing the entry if it is not used anymore.
+     *
+     * @param index The palette index.
+     */
+    void releasePaletteIndex(const uint16_t index);
+
+    /**
+     * @brief Marks the quad of a cell as out of date. Nothing is rebuilt until `updateMesh` or `buildMesh`.
+     *
+     * @param index The index of the cell.
+     */
+    void markDirty(const unsigned int index);
+
+    /**
+     * @brief Brings a mesh that was up to date before some cells got dirty up to date.
+     *
+     * Only the quads of the dirty cells are patched. When most of the chunk changed (e.g. right after generation or
+     * loading), the mesh is rebuilt once from scratch instead.
+     *
+     * @param target The mesh to patch.
+     * @param chunk_index The index of the chunk.
+     * @param scale The scaling factor of the chunk.
+     * @param palette The palette of the chunk.
+     * @param cells The palette index of every cell.
+     * @param tints The tint of every column.
+     * @param dirty_list The cells whose quad is out of date.
+     */
+    static void patchMesh(ChunkMesh &target, const sf::Vector2i &chunk_index, const float scale,
+                          const std::vector<const TileData *> &palette, const TileCells &cells,
+                          const std::array<sf::Color, CHUNK_AREA> &tints, const std::vector<uint16_t> &dirty_list);
+
   public:
     sf::RectangleShape chunkBorders;      ///< Visual border of the chunk for debugging.
-    sf::Vector2<unsigned int> chunkIndex; ///< The index or position of the chunk in the grid.
+    sf::Vector2i chunkIndex; ///< The index or position of the chunk in the grid. May be negative.
 
     float scale; ///< The scaling factor applied to the chunk's size.
 
-    TileMatrix tiles; ///< The 3D grid of tiles that make up the chunk.
-
     uint8_t flags; ///< Flags that specify properties or states of the chunk (from ChunkFlags enum).
 
-    sf::VertexArray vertices;
-
     /**
      * @brief Constructs a Chunk object with the specified parameters.
      *
@@ -74,7 +162,7 @@ class Chunk : public sf::Drawable, public sf::Transformable
      * @param scale The scaling factor applied to the chunk's size.
      * @param flags Optional flags to configure the chunk (default is `ChunkFlags::None`).
      */
-    Chunk(sf::Texture &texture_pack, const sf::Vector2u chunk_index, const float &scale,
+    Chunk(sf::Texture &texture_pack, const sf::Vector2i chunk_index, const float &scale,
           uint8_t flags = ChunkFlags::None);
 
     /**
@@ -82,6 +170,19 @@ class Chunk : public sf::Drawable, public sf::Transformable
      */
     ~Chunk();
 
+    /**
+     * @brief Computes the index of a cell in the cell array.
+     *
+     * @param x The x-coordinate of the cell inside the chunk.
+     * @param y The y-coordinate of the cell inside the chunk.
+     * @param z The z-coordinate (layer) of the cell.
+     * @return The index of the cell.
+     */
+    static constexpr unsigned int cellIndex(const unsigned int x, const unsigned int y, const unsigned int z)
+    {
+        return (z * CHUNK_SIZE_IN_TILES.y + y) * CHUNK_SIZE_IN_TILES.x + x;
+    }
+
     /**
      * @brief Updates the chunk's state.
      *
@@ -92,5 +193,215 @@ class Chunk : public sf::Drawable, public sf::Transformable
      */
     void update(const float &dt);
 
-    void updateVertexArray();
+    /**
+     * @brief Brings the drawn mesh up to date with the cells, right away. Only for chunks nobody draws yet (e.g.
+     * while generating or loading them).
+     *
+     * The cells handed to a build that was not swapped in yet are patched too, and that build will be refused by
+     * `swapMesh`.
+     */
+    void updateMesh();
+
+    /**
+     * @brief Copies what building the mesh needs and hands the dirty cells over to that build. Cheap, so it can run
+     * under the lock of the chunk store while the build itself runs outside of it.
+     *
+     * @return The snapshot, or `std::nullopt` if no cell is dirty.
+     */
+    std::optional<ChunkMeshSnapshot> takeMeshSnapshot();
+
+    /**
+     * @brief Builds the mesh of a snapshot: a copy of the drawn mesh with the dirty cells patched in. Touches neither
+     * the chunk nor any lock, but the chunk must stay alive meanwhile (e.g. by holding a `ChunkStore::ReadGuard`).
+     *
+     * @param snapshot The snapshot taken by `takeMeshSnapshot`.
+     * @return The built mesh.
+     */
+    static ChunkMesh buildMesh(const ChunkMeshSnapshot &snapshot);
+
+    /**
+     * @brief Replaces the drawn mesh with a built one, unless the chunk changed in a way the build doesn't include
+     * (another snapshot was taken, or the mesh was patched in place). Only the thread that draws the chunk may call
+     * this, between two frames.
+     *
+     * @param built The mesh returned by `buildMesh`.
+     * @param mesh_version The mesh version of the snapshot it was built from.
+     * @return True if the mesh was swapped in.
+     */
+    const bool swapMesh(ChunkMesh &&built, const uint64_t mesh_version);
+
+    /**
+     * @brief Opens a batch of edits.
+     *
+     * Edits only ever mark cells as dirty. Closing the outermost batch updates the drawn mesh once, which is how
+     * chunks are built before anybody draws them. Batches can be nested.
+     */
+    void beginBatch();
+
+    /**
+     * @brief Closes a batch of edits, updating the drawn mesh if it was the outermost one.
+     */
+    void endBatch();
+
+    /**
+     * @brief Checks if the mesh has cells waiting to be updated.
+     *
+     * @return True if any cell is dirty.
+     */
+    const bool isDirty() const;
+
+    /**
+     * @brief Gets the amount of vertices currently in the mesh.
+     *
+     * @return The amount of vertices.
+     */
+    const size_t getVertexCount() const;
+
+    /**
+     * @brief Estimates the memory used by the chunk, mesh and palette included.
+     *
+     * @return The amount of bytes.
+     */
+    const size_t getMemoryUsage() const;
+
+    /**
+     * @brief Gets the epoch of the cells. It is incremented on every change, so two equal epochs mean equal cells.
+     *
+     * @return The current epoch.
+     */
+    const uint64_t getEpoch() const;
+
+    /**
+     * @brief Checks if the cells changed since they were last saved.
+     *
+     * @return True if the chunk has changes that are not on disk.
+     */
+    const bool hasUnsavedChanges() const;
+
+    /**
+     * @brief Records that the cells, as they were at a given epoch, are on disk.
+     *
+     * @param epoch The epoch of the cells that were saved (see `getEpoch`).
+     */
+    void markSaved(const uint64_t epoch);
+
+    /**
+     * @brief Gets how far the chunk went through terrain generation.
+     *
+     * @return The generation status.
+     */
+    const ChunkStatus getStatus() const;
+
+    /**
+     * @brief Records that the chunk went through a generation stage.
+     *
+     * @param status The last stage that ran on the chunk.
+     */
+    void setStatus(const ChunkStatus status);
+
+    /**
+     * @brief Places a tile in an empty cell.
+     *
+     * @param data The tile type to place.
+     * @param x The x-coordinate of the cell inside the chunk.
+     * @param y The y-coordinate of the cell inside the chunk.
+     * @param z The z-coordinate (layer) of the cell.
+     * @return If the tile was placed (false if the cell was already occupied).
+     */
+    const bool putTile(const TileData &data, const unsigned int x, const unsigned int y, const unsigned int z);
+
+    /**
+     * @brief Empties a cell.
+     *
+     * @param x The x-coordinate of the cell inside the chunk.
+     * @param y The y-coordinate of the cell inside the chunk.
+     * @param z The z-coordinate (layer) of the cell.
+     * @return If a tile was removed.
+     */
+    const bool removeTile(const unsigned int x, const unsigned int y, const unsigned int z);
+
+    /**
+     * @brief Retrieves the tile type of a cell.
+     *
+     * @param x The x-coordinate of the cell inside the chunk.
+     * @param y The y-coordinate of the cell inside the chunk.
+     * @param z The z-coordinate (layer) of the cell.
+     * @return The tile type, or `nullptr` if the cell is empty.
+     */
+    const TileData *getTileData(const unsigned int x, const unsigned int y, const unsigned int z) const;
+
+    /**
+     * @brief Creates a view over a cell.
+     *
+     * @param x The x-coordinate of the cell inside the chunk.
+     * @param y The y-coordinate of the cell inside the chunk.
+     * @param z The z-coordinate (layer) of the cell.
+     * @return The tile view, or `std::nullopt` if the cell is empty.
+     */
+    std::optional<Tile> getTile(const unsigned int x, const unsigned int y, const unsigned int z) const;
+
+    /**
+     * @brief Finds the top-most occupied layer of a column.
+     *
+     * @param x The x-coordinate of the column inside the chunk.
+     * @param y The y-coordinate of the column inside the chunk.
+     * @return The top-most occupied layer, or -1 if the column is empty.
+     */
+    const int getTopLayer(const unsigned int x, const unsigned int y) const;
+
+    /**
+     * @brief Counts the occupied cells of the chunk.
+     *
+     * @return The amount of tiles in the chunk.
+     */
+    const unsigned int getTileCount() const;
+
+    /**
+     * @brief Retrieves the palette of the chunk. Freed entries are null.
+     *
+     * @return The tile types indexed by the cells.
+     */
+    const std::vector<const TileData *> &getPalette() const;
+
+    /**
+     * @brief Retrieves the palette index of every cell.
+     *
+     * @return The cell array.
+     */
+    const TileCells &getCells() const;
+
+    /**
+     * @brief Copies the cells of the chunk, without its mesh.
+     *
+     * @return The snapshot.
+     */
+    ChunkSaveSnapshot takeSaveSnapshot() const;
+
+    /**
+     * @brief Replaces every cell of the chunk at once.
+     *
+     * Cells pointing outside the palette, or to a null entry, are left empty.
+     *
+     * @param palette The tile types indexed by the cells.
+     * @param cells The palette index of every cell, or `EMPTY_CELL`.
+     */
+    void assign(const std::vector<const TileData *> &palette, const TileCells &cells);
+
+    /**
+     * @brief Retrieves the tint of a column.
+     *
+     * @param x The x-coordinate of the column inside the chunk.
+     * @param y The y-coordinate of the column inside the chunk.
+     * @return The tint of the column.
+     */
+    const sf::Color &getTint(const unsigned int x, const unsigned int y) const;
+
+    /**
+     * @brief Sets the tint of a column. Every tile of the column is rendered with this color.
+     *
+     * @param x The x-coordinate of the column inside the chunk.
+     * @param y The y-coordinate of the column inside the chunk.
+     * @param color The tint of the column.
+     */
+    void setTint(const unsigned int x, const unsigned int y, const sf::Color &color);
 };
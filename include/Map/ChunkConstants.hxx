@@ -0,0 +1,36 @@
+/**
+ * @file ChunkConstants.hxx
+ * @brief Declares the dimensions shared by chunks, chunk meshes and regions.
+ */
+
+#pragma once
+
+/**
+ * @brief The size of a region in chunks (8x8 chunks).
+ */
+static constexpr sf::Vector2u REGION_SIZE_IN_CHUNKS = {8, 8};
+
+/**
+ * @brief The amount of chunks in a region.
+ */
+static constexpr unsigned int REGION_CHUNK_COUNT = REGION_SIZE_IN_CHUNKS.x * REGION_SIZE_IN_CHUNKS.y;
+
+/**
+ * @brief The size of a chunk in tiles (16x16x5 tiles).
+ */
+static constexpr sf::Vector3<unsigned int> CHUNK_SIZE_IN_TILES = {16, 16, 5};
+
+/**
+ * @brief The amount of tile columns (x, y) in a chunk.
+ */
+static constexpr unsigned int CHUNK_AREA = CHUNK_SIZE_IN_TILES.x * CHUNK_SIZE_IN_TILES.y;
+
+/**
+ * @brief The amount of tile cells (x, y, z) in a chunk.
+ */
+static constexpr unsigned int CHUNK_VOLUME = CHUNK_AREA * CHUNK_SIZE_IN_TILES.z;
+
+/**
+ * @brief Palette index that marks an empty cell.
+ */
+static constexpr uint16_t EMPTY_CELL = 0xFFFF;
@@ -0,0 +1,81 @@
+/**
+ * @file ChunkMesh.hxx
+ * @brief Declares the ChunkMesh class to build and patch the vertices of a chunk.
+ */
+
+#pragma once
+
+#include "Map/ChunkConstants.hxx"
+#include "Tiles/TileBase.hxx"
+
+/**
+ * @class ChunkMesh
+ * @brief Holds the renderable quads of a chunk, with a stable quad slot per occupied cell.
+ *
+ * Quads are kept in one vertex array per layer, so upper layers are always drawn over lower ones. Each occupied
+ * cell owns a slot inside the array of its layer: updating a cell patches its six vertices in place, and removing a
+ * cell moves the last quad of the layer into the freed slot. No operation needs to touch the other cells.
+ */
+class ChunkMesh : public sf::Drawable
+{
+  private:
+    std::array<sf::VertexArray, CHUNK_SIZE_IN_TILES.z> layers;          ///< The quads of each layer.
+    std::array<std::vector<uint16_t>, CHUNK_SIZE_IN_TILES.z> slotOwners; ///< The cell owning each quad of a layer.
+    std::array<uint16_t, CHUNK_VOLUME> slots;                          ///< The quad slot of each cell, or `EMPTY_CELL`.
+
+    void draw(sf::RenderTarget &target, sf::RenderStates states = sf::RenderStates::Default) const override;
+
+  public:
+    /**
+     * @brief Constructs an empty ChunkMesh.
+     */
+    ChunkMesh();
+
+    ChunkMesh(const ChunkMesh &) = default;
+    ChunkMesh(ChunkMesh &&) = default;
+    ChunkMesh &operator=(const ChunkMesh &) = default;
+    ChunkMesh &operator=(ChunkMesh &&) = default;
+
+    /**
+     * @brief Destructor for the ChunkMesh class.
+     */
+    ~ChunkMesh();
+
+    /**
+     * @brief Removes every quad of the mesh.
+     */
+    void clear();
+
+    /**
+     * @brief Writes the quad of a cell, allocating a slot for it if the cell has none yet.
+     *
+     * @param cell_index The index of the cell (see `Chunk::cellIndex`).
+     * @param grid_position The grid position of the tile.
+     * @param scale The scale factor for the tile.
+     * @param texture_rect The portion of the texture to be used.
+     * @param color The tint of the tile.
+     */
+    void setQuad(const unsigned int cell_index, const sf::Vector2i &grid_position, const float &scale,
+                 const sf::IntRect &texture_rect, const sf::Color &color);
+
+    /**
+     * @brief Removes the quad of a cell, if any.
+     *
+     * @param cell_index The index of the cell (see `Chunk::cellIndex`).
+     */
+    void removeQuad(const unsigned int cell_index);
+
+    /**
+     * @brief Gets the total amount of vertices of the mesh.
+     *
+     * @return The amount of vertices.
+     */
+    const size_t getVertexCount() const;
+
+    /**
+     * @brief Gets the memory held by the mesh outside of the object itself (vertices and slot owners).
+     *
+     * @return The amount of bytes.
+     */
+    const size_t getMemoryUsage() const;
+};
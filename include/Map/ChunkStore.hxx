@@ -0,0 +1,357 @@
+/**
+ * @file ChunkStore.hxx
+ * @brief Declares the ChunkStore class to hold the resident chunks of a world, sparsely.
+ */
+
+#pragma once
+
+#include "Map/Chunk.hxx"
+#include "Tools/EpochReclaimer.hxx"
+
+/**
+ * @struct ChunkCacheStats
+ * @brief Counters describing how the resident chunks are used.
+ */
+struct ChunkCacheStats
+{
+    size_t chunkCount;  ///< Amount of resident chunks.
+    size_t memoryUsage; ///< Estimated memory used by the resident chunks, in bytes.
+    uint64_t hits;      ///< Lookups that found their chunk.
+    uint64_t misses;    ///< Lookups of a chunk that wasn't resident.
+    uint64_t evictions; ///< Regions unloaded to stay within the memory budget.
+};
+
+/**
+ * @struct ResidentRegion
+ * @brief A loaded region, with when it was last used and how much memory its chunks take.
+ */
+struct ResidentRegion
+{
+    sf::Vector2i regionIndex; ///< The index of the region.
+    uint64_t lastAccess;      ///< The clock tick of the last lookup of one of its chunks.
+    size_t memoryUsage;       ///< Estimated memory used by its chunks, in bytes.
+};
+
+/**
+ * @class ChunkStore
+ * @brief Sparse storage of the resident chunks of a world, keyed by signed 32-bit chunk coordinates.
+ *
+ * Chunks are grouped in pages of one region each, and pages are kept in a hash map keyed by the region coordinates.
+ * Finding a chunk is one hash lookup plus an array index, and memory grows with the amount of regions that hold a
+ * chunk or are loaded, not with the size of the world. Coordinates may be negative or very large: regions are found
+ * by flooring division, so the pages tile the whole plane without overlapping.
+ *
+ * Pages also hold the status of their region (loaded, complete), so a region's status lives exactly as long as the
+ * region is resident. A page is released once its region is unloaded and its last chunk is erased.
+ *
+ * The store also keeps the bookkeeping of a chunk cache: the estimated memory of every chunk, the last clock tick at
+ * which each region was looked up, and hit, miss and eviction counters. Deciding what to evict is left to the owner
+ * (see `getLeastRecentlyUsedRegions`), since only it knows how to save a region before dropping it.
+ *
+ * Reads never take a lock. The page table is copied on write and published through an atomic pointer, chunk slots
+ * are atomic pointers, and chunks, pages and tables that are replaced or erased are retired to an epoch reclaimer
+ * instead of being destroyed. Writers are serialized by a mutex, which readers never touch, so a reader (e.g.
+ * rendering) is never slowed down by streaming, and finds either the old or the new version of anything being
+ * replaced, never a freed one. Chunks are only stored once built, so readers never find a half-built chunk either.
+ *
+ * A pointer returned by `get` stays valid while the caller holds a `ReadGuard` (see `read`), or until the caller
+ * erases or replaces that chunk. The content of a stored chunk is only changed through `edit`, which is serialized
+ * with `clone` and `replace`, so a worker that advances a copy of a chunk never overwrites an edit made meanwhile.
+ * Meshes are built outside of the mutex: `access` only takes a snapshot of the cells, and later swaps the result in.
+ */
+class ChunkStore
+{
+  private:
+    /**
+     * @struct RegionPage
+     * @brief The chunks and status of one region.
+     */
+    struct RegionPage
+    {
+        std::array<std::atomic<Chunk *>, REGION_CHUNK_COUNT> chunks{}; ///< Chunks of the region, by slot. Owned.
+        std::array<uint64_t, REGION_CHUNK_COUNT> revisions{};          ///< Revision of each slot's last change.
+        std::array<size_t, REGION_CHUNK_COUNT> chunkBytes{};           ///< Last measured memory of each chunk.
+        size_t bytes = 0;                                              ///< Sum of `chunkBytes`.
+        unsigned int chunkCount = 0;                                   ///< Amount of chunks in the page.
+        std::atomic_bool loaded{false};                                ///< Whether the region is loaded.
+        std::atomic_bool complete{false};                              ///< Whether every stage ran on the region.
+        std::atomic_uint64_t lastAccess{0};                            ///< Clock tick of the last lookup.
+    };
+
+    using PageTable = std::unordered_map<uint64_t, RegionPage *>;
+
+    mutable std::mutex mutex;             ///< Serializes the writers. Readers never take it.
+    std::atomic<const PageTable *> table; ///< Resident regions, by key. Replaced as a whole on every change.
+    mutable EpochReclaimer reclaimer;     ///< Destroys retired chunks, pages and tables once no reader is left.
+    uint64_t lastRevision;                ///< Last revision given to a slot change. Guarded by the mutex.
+    std::atomic_size_t chunkCount;        ///< Amount of chunks in every page.
+    std::atomic_size_t memoryUsage;       ///< Sum of the bytes of every page.
+
+    std::atomic_uint64_t clock;          ///< Advanced by `tick`, stamped on the pages that are looked up.
+    mutable std::atomic_uint64_t hits;   ///< Lookups that found their chunk.
+    mutable std::atomic_uint64_t misses; ///< Lookups of a chunk that wasn't resident.
+    std::atomic_uint64_t evictions;      ///< Regions evicted by the owner.
+
+    /**
+     * @brief Packs region coordinates into a hash map key.
+     *
+     * @param region_index The index of the region.
+     * @return The key of the region.
+     */
+    static const uint64_t getKey(const sf::Vector2i &region_index);
+
+    /**
+     * @brief Gets the position of a chunk inside the page of its region.
+     *
+     * @param chunk_index The index of the chunk.
+     * @return The slot of the chunk.
+     */
+    static const unsigned int getSlot(const sf::Vector2i &chunk_index);
+
+    /**
+     * @brief Finds the page of a region. The caller must have an epoch pinned, or hold the mutex.
+     *
+     * @param region_index The index of the region.
+     * @return The page, or `nullptr` if the region isn't resident.
+     */
+    RegionPage *findPage(const sf::Vector2i &region_index) const;
+
+    /**
+     * @brief Gets the page of a region, publishing a new one if needed. The caller must hold the mutex.
+     *
+     * @param region_index The index of the region.
+     * @return The page.
+     */
+    RegionPage &acquirePage(const sf::Vector2i &region_index);
+
+    /**
+     * @brief Retires the page of a region if it holds nothing anymore. The caller must hold the mutex.
+     *
+     * @param region_index The index of the region.
+     */
+    void releasePageIfUnused(const sf::Vector2i &region_index);
+
+    /**
+     * @brief Measures the memory of a chunk slot again. The caller must hold the mutex.
+     *
+     * @param page The page of the chunk.
+     * @param slot The slot of the chunk.
+     */
+    void measure(RegionPage &page, const unsigned int slot);
+
+  public:
+    /**
+     * @brief Constructs an empty ChunkStore.
+     */
+    ChunkStore();
+
+    /**
+     * @brief Destructor for the ChunkStore class.
+     */
+    ~ChunkStore();
+
+    /**
+     * @brief Gets the region holding a chunk, rounding towards negative infinity.
+     *
+     * @param chunk_index The index of the chunk.
+     * @return The index of the region.
+     */
+    static const sf::Vector2i getRegionIndex(const sf::Vector2i &chunk_index);
+
+    using ReadGuard = EpochReclaimer::Guard;
+
+    /**
+     * @brief Starts reading: chunks found by `get` stay valid until the returned guard is destroyed. Lock-free.
+     *
+     * @return The guard.
+     */
+    ReadGuard read() const;
+
+    /**
+     * @brief Gets a resident chunk, counting a hit or a miss and marking its region as used. Lock-free.
+     *
+     * @param chunk_index The index of the chunk.
+     * @return The chunk, or `nullptr` if it isn't resident.
+     */
+    Chunk *get(const sf::Vector2i &chunk_index) const;
+
+    /**
+     * @brief Stores a finished chunk, unless a chunk is already resident at the same index.
+     *
+     * @param chunk_index The index of the chunk.
+     * @param chunk The chunk to store.
+     * @return True if the chunk was stored, false if it was dropped.
+     */
+    const bool insert(const sf::Vector2i &chunk_index, std::unique_ptr<Chunk> chunk);
+
+    /**
+     * @brief Copies a resident chunk, so it can be worked on without readers seeing the work in progress.
+     *
+     * @param chunk_index The index of the chunk.
+     * @param revision Set to the revision of the copied chunk, to pass to `replace`.
+     * @return The copy, or `nullptr` if the chunk isn't resident.
+     */
+    std::unique_ptr<Chunk> clone(const sf::Vector2i &chunk_index, uint64_t &revision) const;
+
+    /**
+     * @brief Replaces a resident chunk with a finished one, unless it changed since it was cloned. The replaced
+     * chunk is retired.
+     *
+     * @param chunk_index The index of the chunk.
+     * @param chunk The chunk to store.
+     * @param revision The revision given by `clone`.
+     * @return True if the chunk was replaced, false if it was dropped because the resident chunk changed.
+     */
+    const bool replace(const sf::Vector2i &chunk_index, std::unique_ptr<Chunk> chunk, const uint64_t revision);
+
+    /**
+     * @brief Changes a resident chunk of a loaded region in place, serialized with the other writers.
+     *
+     * Chunks of regions that aren't loaded are refused. Unloading clears the status of a region before saving it, so
+     * an edit never lands between the save and the release of the chunks.
+     *
+     * @param chunk_index The index of the chunk.
+     * @param callback The function changing the chunk.
+     * @return True if the chunk is resident in a loaded region and the function was called.
+     */
+    template <typename F> const bool edit(const sf::Vector2i &chunk_index, F &&callback)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        RegionPage *page = findPage(getRegionIndex(chunk_index));
+        const unsigned int slot = getSlot(chunk_index);
+
+        Chunk *chunk = page && page->loaded.load() ? page->chunks[slot].load() : nullptr;
+        if (!chunk)
+            return false;
+
+        page->revisions[slot] = ++lastRevision;
+        callback(*chunk);
+
+        return true;
+    }
+
+    /**
+     * @brief Calls a function on a resident chunk, serialized with the other writers, without counting as a change
+     * of the chunk. Only for the bookkeeping that leaves the cells alone (taking a snapshot, swapping a built mesh,
+     * reading or marking the saved epoch), which a clone taken meanwhile reconciles on its own, or at worst saves
+     * again, so it must not make `replace` drop that clone. Keep the function short: every writer waits for it.
+     *
+     * @param chunk_index The index of the chunk.
+     * @param callback The function to call with the chunk.
+     * @return True if the chunk is resident and the function was called.
+     */
+    template <typename F> const bool access(const sf::Vector2i &chunk_index, F &&callback)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        RegionPage *page = findPage(getRegionIndex(chunk_index));
+        Chunk *chunk = page ? page->chunks[getSlot(chunk_index)].load() : nullptr;
+        if (!chunk)
+            return false;
+
+        callback(*chunk);
+
+        return true;
+    }
+
+    /**
+     * @brief Erases a resident chunk, which is destroyed once no reader is left. Does nothing if it isn't resident.
+     *
+     * @param chunk_index The index of the chunk.
+     */
+    void erase(const sf::Vector2i &chunk_index);
+
+    /**
+     * @brief Calls a function on every resident chunk. Lock-free. The function must not modify the store.
+     *
+     * @param callback The function to call with each chunk.
+     */
+    template <typename F> void forEach(F &&callback) const
+    {
+        const ReadGuard guard = read();
+
+        for (const auto &[key, page] : *table.load())
+        {
+            for (const auto &slot : page->chunks)
+            {
+                if (Chunk *chunk = slot.load())
+                    callback(*chunk);
+            }
+        }
+    }
+
+    /**
+     * @brief Checks if a region is loaded.
+     *
+     * @param region_index The index of the region.
+     * @return True if the region is loaded.
+     */
+    const bool isRegionLoaded(const sf::Vector2i &region_index) const;
+
+    /**
+     * @brief Checks if every generation stage ran on a loaded region.
+     *
+     * @param region_index The index of the region.
+     * @return True if the region is loaded and complete.
+     */
+    const bool isRegionComplete(const sf::Vector2i &region_index) const;
+
+    /**
+     * @brief Sets the status of a region. Unloading a region also clears its complete status.
+     *
+     * Loading a region marks it as used, and measures the memory of its chunks again, since they were most likely
+     * just generated or read.
+     *
+     * @param region_index The index of the region.
+     * @param loaded Whether the region is loaded.
+     * @param complete Whether every generation stage ran on the region.
+     */
+    void setRegionStatus(const sf::Vector2i &region_index, const bool loaded, const bool complete);
+
+    /**
+     * @brief Gets the loaded regions.
+     *
+     * @return The indexes of the loaded regions, in no particular order.
+     */
+    std::vector<sf::Vector2i> getLoadedRegions() const;
+
+    /**
+     * @brief Gets the loaded regions, least recently used first.
+     *
+     * @return The loaded regions, with their last access and memory.
+     */
+    std::vector<ResidentRegion> getLeastRecentlyUsedRegions() const;
+
+    /**
+     * @brief Gets the amount of resident chunks.
+     *
+     * @return The amount of chunks.
+     */
+    const size_t getChunkCount() const;
+
+    /**
+     * @brief Gets the estimated memory used by the resident chunks, as last measured.
+     *
+     * @return The amount of bytes.
+     */
+    const size_t getMemoryUsage() const;
+
+    /**
+     * @brief Advances the clock the lookups are stamped with, and destroys the retired objects no reader can reach
+     * anymore. Called once per frame.
+     */
+    void tick();
+
+    /**
+     * @brief Counts a region that was unloaded to stay within the memory budget.
+     */
+    void recordEviction();
+
+    /**
+     * @brief Gets the cache counters.
+     *
+     * @return The counters.
+     */
+    const ChunkCacheStats getStats() const;
+};
@@ -5,12 +5,84 @@
 
 #pragma once
 
+#include "Map/BiomeRules.hxx"
+#include "Map/RegionFile.hxx"
+#include "Map/RegionStreamer.hxx"
 #include "Map/TerrainGenerator.hxx"
 #include "Tiles/Tile.hxx"
 #include "Tiles/TileDatabase.hxx"
 #include "Tools/JSON.hxx"
 #include "Tools/LinearCongruentialGenerator.hxx"
 #include "Tools/Logger.hxx"
+#include "Tools/Profiler.hxx"
+
+/**
+ * @brief Regions closer than this to the player are loaded (in tiles).
+ */
+static constexpr float REGION_LOAD_DISTANCE = CHUNK_SIZE_IN_TILES.x;
+
+/**
+ * @brief Regions farther than this from the player are unloaded (in tiles).
+ *
+ * Kept well above `REGION_LOAD_DISTANCE`, so walking back and forth along a region border doesn't make the same
+ * region load and unload over and over.
+ */
+static constexpr float REGION_UNLOAD_DISTANCE = REGION_SIZE_IN_CHUNKS.x * CHUNK_SIZE_IN_TILES.x;
+
+/**
+ * @brief Added to the distance of a region to get the priority of its decoration.
+ *
+ * It is above every load priority, so the base terrain of every nearby region is in place before any decoration
+ * runs.
+ */
+static constexpr float REGION_DECORATION_PRIORITY_OFFSET = REGION_UNLOAD_DISTANCE;
+
+/**
+ * @brief How often the region requests are scheduled again while the player stands still (in seconds).
+ *
+ * Chunks keep growing while the player stands still (e.g. decorations finishing), so the memory budget is checked
+ * on this interval too, not only when the player moves.
+ */
+static constexpr float REGION_STREAMING_INTERVAL = 1.f;
+
+/**
+ * @brief The amount of workers building the meshes of edited chunks.
+ */
+static constexpr unsigned int MESH_WORKER_COUNT = 2;
+
+/**
+ * @enum RegionSaveMode
+ * @brief How the chunks of a region are written to its file.
+ */
+enum class RegionSaveMode : uint8_t
+{
+    Full,  ///< Every cell of every resident chunk is written.
+    Delta, ///< Only the changes to the generated terrain are written. The rest is generated again on load.
+};
+
+/**
+ * @struct RegionWrite
+ * @brief A queued write of a region file, with the epochs of the chunks it holds.
+ *
+ * The chunks only count as saved once the write reached the disk, so a failed write never lets their changes be
+ * dropped.
+ */
+struct RegionWrite
+{
+    sf::Vector2i regionIndex;                              ///< The index of the region.
+    std::shared_future<bool> written;                      ///< Whether the file was written.
+    std::vector<std::pair<sf::Vector2i, uint64_t>> epochs; ///< The epoch of each chunk the write holds.
+};
+
+/**
+ * @struct MapRenderStats
+ * @brief What the last call to `Map::render` drew.
+ */
+struct MapRenderStats
+{
+    unsigned int drawnChunks; ///< Amount of chunks drawn.
+    size_t vertexCount;       ///< Amount of vertices of the drawn chunks.
+};
 
 /**
  * @class Map
@@ -36,26 +108,41 @@ class Map
 
     std::unique_ptr<TerrainGenerator> terrainGenerator; ///< Unique pointer to the terrain generator.
 
-    TileDatabase &tileDb;     ///< Reference to the tile database.
-    sf::Texture &texturePack; ///< Reference to the texture pack used for tiles.
+    TileDatabase &tileDb;         ///< Reference to the tile database.
+    const BiomeRules &biomeRules; ///< Reference to the generation rules of the biomes.
+    sf::Texture &texturePack;     ///< Reference to the texture pack used for tiles.
+
+    TileIdTable tileIds; ///< Stable IDs of the tile types saved in this world's region files.
+
+    float scale; ///< Scaling factor for rendering the map.
 
-    float scale;           ///< Scaling factor for rendering the map.
+    ChunkStore chunks;   ///< Resident chunks of the map, with the status of their regions.
+    size_t memoryBudget; ///< Memory the resident chunks should stay within, in bytes.
 
-    ChunkMatrix chunks;                                           ///< 2D array of chunks in the map.
-    std::atomic_bool loadedRegions[MAX_REGIONS.x][MAX_REGIONS.y]; ///< Array to track loaded regions.
+    RegionSaveMode saveMode; ///< How regions are written to disk.
 
     Random rng; ///< Random number generator for procedural generation.
 
+    sf::Vector2i streamingPosition; ///< The player position the region requests were last scheduled for.
+    float streamingTimer;           ///< Time since the region requests were last scheduled (in seconds).
+
+    MapRenderStats renderStats; ///< What the last frame drew.
+
+    std::mutex writesMutex;                ///< Guards `regionWrites`.
+    std::vector<RegionWrite> regionWrites; ///< Region writes that were queued, but not confirmed yet.
+
+    std::vector<sf::Vector2i> dirtyChunks;                            ///< Edited chunks waiting for a mesh build.
+    std::vector<std::pair<sf::Vector2i, std::future<std::optional<std::pair<uint64_t, ChunkMesh>>>>>
+        meshJobs; ///< Mesh builds in flight, by chunk, each yielding the mesh and the version it was built from.
+    std::unique_ptr<ThreadPool> meshPool; ///< Workers building the meshes of edited chunks. Destroyed before chunks.
+
+    std::unique_ptr<RegionStreamer> streamer; ///< Worker pool that loads and unloads regions. Destroyed first.
+
     /**
      * @brief Initializes the loading screen process.
      */
     void initLoadingScreen();
 
-    /**
-     * @brief Initializes the array to track the status of loaded regions.
-     */
-    void initRegionStatusArray();
-
     /**
      * @brief Initializes the metadata for the map.
      * @param name Name of the map.
@@ -66,8 +153,86 @@ class Map
     /**
      * @brief Initializes the terrain generator.
      * @param seed Seed for terrain generation.
+     * @param generate_spawn Whether to generate the regions around the spawn point before the map is ready.
+     */
+    void initTerrainGenerator(const long int &seed, const bool generate_spawn);
+
+    /**
+     * @brief Initializes the region streamer.
+     */
+    void initRegionStreamer();
+
+    /**
+     * @brief Computes the distance from a grid position to the closest tile of a region.
+     * @param region_index The index of the region.
+     * @param grid_pos The grid position.
+     * @return The distance in tiles (0 if the position is inside the region).
+     */
+    const float getRegionDistance(const sf::Vector2i &region_index, const sf::Vector2i &grid_pos) const;
+
+    /**
+     * @brief Gets the regions within `REGION_LOAD_DISTANCE` of a grid position.
+     * @param grid_pos The position in the grid. May be negative.
+     * @return The indexes of the regions.
+     */
+    const std::vector<sf::Vector2i> getRegionsInReach(const sf::Vector2i &grid_pos) const;
+
+    /**
+     * @brief Checks if any chunk of a region changed since it was last saved. The caller must hold the mutex.
+     * @param region_index The index of the region.
+     * @return True if the region needs to be written.
+     */
+    const bool hasUnsavedChanges(const sf::Vector2i &region_index);
+
+    /**
+     * @brief Snapshots the chunks of a region and queues the snapshot to be written in the background. Chunks are
+     * saved with their generation status, so a region that wasn't decorated yet is decorated after loading instead
+     * of on the caller's thread. In delta mode, complete chunks that were never edited are left out, and the others
+     * only record their changes, which are diffed from snapshots of their cells on the write worker. The caller must
+     * hold the mutex.
+     * @param region_index The index of the region.
+     */
+    void queueRegionWrite(const sf::Vector2i &region_index);
+
+    /**
+     * @brief Queues the eviction of the least recently used regions while the chunks are over the memory budget.
+     *
+     * Regions within `REGION_LOAD_DISTANCE` of the player are never evicted, since they would be loaded again right
+     * away, so the budget can only be kept if it fits the regions around the player.
+     * @param tasks The tasks about to be scheduled. Regions they already unload count as freed.
+     * @param player_pos_grid Player's position in the grid.
+     */
+    void queueEvictions(std::vector<RegionTask> &tasks, const sf::Vector2i &player_pos_grid) const;
+
+    /**
+     * @brief Queues an edited chunk for a mesh build. Edits of the same chunk until the next frame share one build.
+     * @param chunk_index The index of the chunk.
      */
-    void initTerrainGenerator(const long int &seed);
+    void queueMeshBuild(const sf::Vector2i &chunk_index);
+
+    /**
+     * @brief Swaps in the meshes the workers finished, then hands the queued chunks to the workers. Called once per
+     * frame, so the render only ever draws finished meshes, and a chunk only ever has one build in flight.
+     */
+    void updateMeshes();
+
+    /**
+     * @brief Marks the chunks of the region writes that reached the disk as saved. A chunk whose write failed keeps
+     * its changes, and is written again by the next save or unload of its region. Called once per frame.
+     */
+    void updateRegionWrites();
+
+    /**
+     * @brief Waits for every queued write of a region, and marks the chunks of those that reached the disk as saved.
+     * @param region_index The index of the region.
+     */
+    void waitForRegionWrites(const sf::Vector2i &region_index);
+
+    /**
+     * @brief Marks the chunks of a finished region write as saved, if it reached the disk.
+     * @param write The finished write.
+     */
+    void confirmRegionWrite(const RegionWrite &write);
 
     /**
      * @brief Sets the readiness status of the map.
@@ -81,19 +246,21 @@ class Map
      * @param name Name of the map.
      * @param seed Seed for world generation.
      * @param tile_db Reference to the tile database.
+     * @param biome_rules Reference to the generation rules of the biomes.
      * @param texture_pack Reference to the texture pack used.
      * @param scale Scaling factor for rendering the map.
      */
-    Map(const std::string &name, const long int &seed, TileDatabase &tile_db, sf::Texture &texture_pack,
-        const float &scale);
+    Map(const std::string &name, const long int &seed, TileDatabase &tile_db, const BiomeRules &biome_rules,
+        sf::Texture &texture_pack, const float &scale);
 
     /**
      * @brief Constructor that initializes an empty map.
      * @param tile_db Reference to the tile database.
+     * @param biome_rules Reference to the generation rules of the biomes.
      * @param texture_pack Reference to the texture pack used.
      * @param scale Scaling factor for rendering the map.
      */
-    Map(TileDatabase &tile_db, sf::Texture &texture_pack, const float &scale);
+    Map(TileDatabase &tile_db, const BiomeRules &biome_rules, sf::Texture &texture_pack, const float &scale);
 
     /**
      * @brief Destructor for cleaning up the map.
@@ -102,25 +269,33 @@ class Map
 
     /**
      * @brief Updates the map based on the player's position and time delta.
+     *
+     * Whenever the player moves, the regions near the player that aren't loaded are queued for loading, and the
+     * loaded regions far from the player are queued for unloading. Closer regions are handled first. If the chunks
+     * are over the memory budget, the least recently used regions are queued for eviction too. Every frame, the
+     * meshes of the edited chunks are swapped in once built, and built again if they were edited since.
      * @param dt Time delta for updating the map.
      * @param player_pos_grid Player's position in the grid.
      */
     void update(const float &dt, const sf::Vector2i &player_pos_grid);
 
     /**
-     * @brief Renders the map to a render target.
+     * @brief Renders the chunks visible through the current view of a render target.
      * @param target The render target to render to.
-     * @param debug Flag to indicate if debug information should be rendered.
+     * @param debug Flag to indicate if the chunk borders should be rendered.
      */
     void render(sf::RenderTarget &target, const bool &debug = false);
 
     /**
-     * @brief Renders the map based on an entity's position in the grid.
+     * @brief Renders the chunks visible through a view.
+     *
+     * Only the chunks overlapping the bounds of the view are looked up, so the cost follows what is on screen, for
+     * any resolution or zoom.
      * @param target The render target to render to.
-     * @param entity_pos_grid The entity's position in the grid.
-     * @param debug Flag to indicate if debug information should be rendered.
+     * @param view The view the target is rendered with.
+     * @param debug Flag to indicate if the chunk borders should be rendered.
      */
-    void render(sf::RenderTarget &target, const sf::Vector2i &entity_pos_grid, const bool &debug);
+    void render(sf::RenderTarget &target, const sf::View &view, const bool &debug);
 
     /**
      * @brief Saves the map to a file with a specific name.
@@ -134,7 +309,7 @@ class Map
     void save();
 
     /**
-     * @brief Saves the specified region of the map to a file.
+     * @brief Saves the specified region of the map to a file, if it has unsaved changes.
      * @param region_index The index of the region to save.
      */
     void saveRegion(const sf::Vector2i &region_index);
@@ -152,36 +327,51 @@ class Map
     void loadRegion(const sf::Vector2i &region_index);
 
     /**
-     * @brief Unloads the specified region of the map.
+     * @brief Runs the generation stages left after the base terrain (e.g. decorations) on a loaded region.
+     * @param region_index The index of the region to decorate.
+     */
+    void decorateRegion(const sf::Vector2i &region_index);
+
+    /**
+     * @brief Unloads the specified region of the map, saving it first if it has unsaved changes. The chunks are only
+     * dropped once they are on disk: if the write fails, the region stays loaded, and the next unload tries again.
      * @param region_index The index of the region to unload.
+     * @return True if the region was unloaded.
+     */
+    const bool unloadRegion(const sf::Vector2i &region_index);
+
+    /**
+     * @brief Unloads a region to free memory, like `unloadRegion`, and counts it as an eviction.
+     * @param region_index The index of the region to evict.
      */
-    void unloadRegion(const sf::Vector2i &region_index);
+    void evictRegion(const sf::Vector2i &region_index);
 
     /**
      * @brief Places a tile in the world at the specified coordinates.
-     * @param tile The tile to place.
+     * @param tile_data The type of the tile to place.
      * @param grid_x The x-coordinate in the grid.
      * @param grid_y The y-coordinate in the grid.
      * @param grid_z The z-coordinate in the grid.
+     * @return If the tile was placed. Tiles are only placed in chunks of loaded regions.
      */
-    void putTile(Tile tile, const int &grid_x, const int &grid_y, const int &grid_z);
+    const bool putTile(const TileData &tile_data, const int &grid_x, const int &grid_y, const int &grid_z);
 
     /**
      * @brief Retrieves a tile at the specified coordinates.
      * @param grid_x The x-coordinate in the grid.
      * @param grid_y The y-coordinate in the grid.
      * @param grid_z The z-coordinate in the grid.
-     * @return A pointer to the tile at the specified coordinates.
+     * @return A view of the tile at the specified coordinates, or `std::nullopt` if there is none.
      */
-    Tile *getTile(const int &grid_x, const int &grid_y, const int &grid_z);
+    std::optional<Tile> getTile(const int &grid_x, const int &grid_y, const int &grid_z);
 
     /**
      * @brief Retrieves the top-most tile at the specified coordinates.
      * @param grid_x The x-coordinate in the grid.
      * @param grid_y The y-coordinate in the grid.
-     * @return A pointer to the tile at the specified coordinates.
+     * @return A view of the top-most tile at the specified coordinates, or `std::nullopt` if there is none.
      */
-    Tile *getTile(const int &grid_x, const int &grid_y);
+    std::optional<Tile> getTile(const int &grid_x, const int &grid_y);
 
     /**
      * @brief Removes a tile at the specified coordinates.
@@ -261,8 +451,48 @@ class Map
     /**
      * @brief Checks if a specific region is loaded.
      * @param region_index The index of the region to check.
-     * @return True if the region is loaded, false if not, `std::nullopt`
-     * if region is out of bounds.
+     * @return True if the region is loaded, false if not.
+     */
+    const bool isRegionLoaded(const sf::Vector2i &region_index);
+
+    /**
+     * @brief Sets the memory the resident chunks should stay within. Once the chunks take more than this, the least
+     * recently used regions out of the player's reach are evicted.
+     * @param bytes The budget, in bytes.
+     */
+    void setMemoryBudget(const size_t bytes);
+
+    /**
+     * @brief Retrieves the memory the resident chunks should stay within.
+     * @return The budget, in bytes.
+     */
+    const size_t getMemoryBudget() const;
+
+    /**
+     * @brief Sets how regions are written to disk from now on. Files of either mode can always be read. The mode is
+     * kept in the world metadata ("saveMode"), so it survives reloading the world.
+     *
+     * Delta saves rely on the terrain being generated again exactly the same, so they should only be used while
+     * the seed, the generator version and the biome rules of the world stay the same.
+     * @param mode The save mode.
+     */
+    void setSaveMode(const RegionSaveMode mode);
+
+    /**
+     * @brief Retrieves how regions are written to disk.
+     * @return The save mode.
+     */
+    const RegionSaveMode getSaveMode() const;
+
+    /**
+     * @brief Retrieves what the last call to `render` drew.
+     * @return The amount of drawn chunks and vertices.
+     */
+    const MapRenderStats &getRenderStats() const;
+
+    /**
+     * @brief Retrieves the counters of the chunk cache (memory, hits, misses, evictions).
+     * @return The counters.
      */
-    const std::optional<bool> isRegionLoaded(const sf::Vector2i &region_index);
+    const ChunkCacheStats getCacheStats() const;
 };
@@ -39,6 +39,7 @@ struct Metadata
     std::string generatorName;   ///< Name of the generator used for the map.
     long long lastPlayed;        ///< The last played timestamp of the map (in epoch time).
     std::string name;            ///< Name of the map.
+    std::string saveMode;        ///< How the regions of the map are written to disk ("full" or "delta").
     long long seed;              ///< Seed used for the generation of the map.
     long long spawnX;            ///< X-coordinate of the spawn point.
     long long spawnY;            ///< Y-coordinate of the spawn point.
@@ -66,6 +67,7 @@ inline JObject &operator<<(JObject &obj, Metadata &metadata)
                    }},
                   {"dayTime", metadata.dayTime},
                   {"name", metadata.name},
+                  {"saveMode", metadata.saveMode},
                   {"difficulty", metadata.difficulty},
                   {"seed", metadata.seed},
                   {"generatorName", metadata.generatorName},
@@ -100,6 +102,8 @@ inline JObject &operator>>(JObject &obj, Metadata &metadata)
     metadata.generatorName = obj.at("generatorName").getAs<std::string>();
     metadata.lastPlayed = obj.at("lastPlayed").getAs<long long>();
     metadata.name = obj.at("name").getAs<std::string>();
+    // Worlds saved before the key existed are written in full.
+    metadata.saveMode = obj.count("saveMode") ? obj.at("saveMode").getAs<std::string>() : "full";
     metadata.seed = obj.at("seed").getAs<long long>();
     metadata.spawnX = obj.at("spawnX").getAs<long long>();
     metadata.spawnY = obj.at("spawnY").getAs<long long>();
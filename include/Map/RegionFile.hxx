@@ -0,0 +1,315 @@
+/**
+ * @file RegionFile.hxx
+ * @brief Declares the RegionFile class to read and write region files.
+ */
+
+#pragma once
+
+#include "Engine/Languages.hxx"
+#include "Map/Chunk.hxx"
+#include "Map/TileIdTable.hxx"
+#include "Tiles/TileDatabase.hxx"
+#include "Tools/Logger.hxx"
+#include "Tools/Profiler.hxx"
+#include "Tools/ThreadPool.hxx"
+#include "zlib.h"
+
+/**
+ * @brief Magic bytes at the start of every versioned region file.
+ *
+ * Legacy region files start with the x index of their first chunk, which can never match these bytes.
+ */
+static constexpr char REGION_FILE_MAGIC[4] = {'P', 'M', 'R', 'G'};
+
+/**
+ * @brief The current version of the region file format.
+ */
+static constexpr uint16_t REGION_FILE_VERSION = 5;
+
+/**
+ * @brief The version given to region files written before the format was versioned.
+ */
+static constexpr uint16_t REGION_FILE_LEGACY_VERSION = 1;
+
+/**
+ * @brief Marks the cells of a delta record that hold the same tile as the generated terrain.
+ */
+static constexpr uint16_t UNCHANGED_CELL = 0xFFFE;
+
+/**
+ * @brief The amount of worker threads that compress and write region files in the background.
+ */
+static constexpr unsigned int REGION_WRITE_WORKERS = 2;
+
+/**
+ * @struct ChunkRecord
+ * @brief The serialized form of a chunk: its flags, its generation status, a palette of world tile IDs and its
+ * cells.
+ *
+ * A delta record only holds the cells that differ from the generated terrain. Its other cells are `UNCHANGED_CELL`,
+ * and the chunk has to be generated before the record is applied on top of it.
+ */
+struct ChunkRecord
+{
+    uint8_t flags;                              ///< The flags of the chunk (from ChunkFlags enum).
+    bool delta = false;                         ///< Whether the cells are relative to the generated terrain.
+    ChunkStatus status = ChunkStatus::Complete; ///< How far the chunk was generated. Deltas are always complete.
+    std::vector<WorldTileId> palette;           ///< The world IDs of the tile types used by the chunk.
+    TileCells cells;                            ///< Palette index of every cell, `EMPTY_CELL`, or `UNCHANGED_CELL`.
+};
+
+/**
+ * @typedef RegionRecords
+ * @brief One optional record per chunk slot of a region. Slots without a chunk are empty.
+ */
+using RegionRecords = std::array<std::optional<ChunkRecord>, REGION_CHUNK_COUNT>;
+
+/**
+ * @class RegionFile
+ * @brief A utility class to read and write region files.
+ *
+ * A region file starts with a header holding the magic bytes, the format version and a table with the offset and
+ * length of each of the region's chunks. Each chunk is stored as its flags, whether it is a delta record, its
+ * generation status, its palette of world tile IDs and its cell array compressed with zlib. Cells are stored as one
+ * byte each when the palette is small enough, and as two bytes otherwise. Thanks to the table, a single chunk can be
+ * read without reading the others. Files are only ever written whole, next to the old one and renamed over it, so a
+ * crash never leaves a half-written table or chunk.
+ *
+ * Older region files can be read into current records with `upgrade`: the legacy, unversioned format (a flat
+ * stream of chunk headers followed by one entry per tile) and version 2 both identify tiles by a 64-bit hash of
+ * their tag, which is resolved through the tile database. Version 3 is the current format without delta records nor
+ * statuses, and version 4 without statuses. Chunks of both are complete.
+ */
+class RegionFile
+{
+  private:
+    /**
+     * @struct ChunkSlot
+     * @brief The location of a chunk inside a region file.
+     */
+    struct ChunkSlot
+    {
+        uint32_t offset; ///< Offset of the chunk from the start of the file, in bytes.
+        uint32_t length; ///< Length of the chunk, in bytes. 0 if the slot has no chunk.
+    };
+
+    using SlotTable = std::array<ChunkSlot, REGION_CHUNK_COUNT>;
+
+    static std::mutex writeMutex;                                                   ///< Guards `pendingWrites`.
+    static std::unordered_map<std::string, std::shared_future<bool>> pendingWrites; ///< Last write of each file.
+
+    /**
+     * @brief Gets the pool that runs the background writes. It outlives every world, so no write is ever dropped.
+     *
+     * @return The write pool.
+     */
+    static ThreadPool &getWritePool();
+
+    /**
+     * @brief The size of the header, table included, in bytes.
+     */
+    static constexpr uint32_t HEADER_SIZE =
+        sizeof(REGION_FILE_MAGIC) + sizeof(uint16_t) + sizeof(uint16_t) + REGION_CHUNK_COUNT * 2 * sizeof(uint32_t);
+
+    /**
+     * @typedef HashedPalettes
+     * @brief The tile hashes of each chunk of an older region file, indexed by chunk slot.
+     */
+    using HashedPalettes = std::array<std::vector<uint64_t>, REGION_CHUNK_COUNT>;
+
+    /**
+     * @brief Reads and validates the header of a region file.
+     *
+     * @param file The region file, positioned at its start.
+     * @param table The table to fill.
+     * @param version The version the file must have.
+     * @return `true` if the header is valid, `false` otherwise.
+     */
+    static const bool readHeader(std::istream &file, SlotTable &table, const uint16_t version = REGION_FILE_VERSION);
+
+    /**
+     * @brief Writes the header of a region file.
+     *
+     * @param file The region file, positioned at its start.
+     * @param table The table to write.
+     */
+    static void writeHeader(std::ostream &file, const SlotTable &table);
+
+    /**
+     * @brief Serializes and compresses a chunk record.
+     *
+     * @param record The record to encode.
+     * @param bytes The buffer to write the encoded chunk to.
+     * @return `true` if the chunk was encoded, `false` if compression failed.
+     */
+    static const bool encodeChunk(const ChunkRecord &record, std::vector<char> &bytes);
+
+    /**
+     * @brief Decompresses and deserializes a chunk record.
+     *
+     * @param bytes The encoded chunk.
+     * @param record The record to fill.
+     * @param version The version of the file the chunk comes from (3 or later).
+     * @return `true` if the chunk was decoded, `false` if it is corrupted.
+     */
+    static const bool decodeChunk(const std::vector<char> &bytes, ChunkRecord &record,
+                                  const uint16_t version = REGION_FILE_VERSION);
+
+    /**
+     * @brief Reads every chunk of a region file of version 3 or later.
+     *
+     * @param path The path to the region file.
+     * @param records The records to fill, indexed by chunk slot.
+     * @param version The version the file must have.
+     * @return `true` if the file was read, `false` otherwise.
+     */
+    static const bool readRecords(const std::filesystem::path &path, RegionRecords &records, const uint16_t version);
+
+    /**
+     * @brief Reads a legacy, unversioned region file.
+     *
+     * @param path The path to the region file.
+     * @param records The records to fill. Their palettes are left empty.
+     * @param hashes The tile hashes of each chunk, indexed like the palettes would be.
+     * @return `true` if the file was read, `false` otherwise.
+     */
+    static const bool readLegacy(const std::filesystem::path &path, RegionRecords &records, HashedPalettes &hashes);
+
+    /**
+     * @brief Reads a version 2 region file.
+     *
+     * @param path The path to the region file.
+     * @param records The records to fill. Their palettes are left empty.
+     * @param hashes The tile hashes of each chunk, indexed like the palettes would be.
+     * @return `true` if the file was read, `false` otherwise.
+     */
+    static const bool readVersion2(const std::filesystem::path &path, RegionRecords &records, HashedPalettes &hashes);
+
+  public:
+    /**
+     * @brief Gets the slot of a chunk inside the file of its region.
+     *
+     * @param chunk_index The index of the chunk in the world.
+     * @return The slot of the chunk.
+     */
+    static const unsigned int getSlot(const sf::Vector2i &chunk_index);
+
+    /**
+     * @brief Gets the format version of a region file.
+     *
+     * @param path The path to the region file.
+     * @return The version of the file, `REGION_FILE_LEGACY_VERSION` if it doesn't start with the magic bytes, or 0
+     * if it can't be opened.
+     */
+    static const uint16_t getVersion(const std::filesystem::path &path);
+
+    /**
+     * @brief Reads every chunk of a region file.
+     *
+     * @param path The path to the region file.
+     * @param records The records to fill, indexed by chunk slot.
+     * @return `true` if the file was read, `false` otherwise.
+     */
+    static const bool read(const std::filesystem::path &path, RegionRecords &records);
+
+    /**
+     * @brief Reads a single chunk of a region file.
+     *
+     * @param path The path to the region file.
+     * @param slot The slot of the chunk (see `getSlot`).
+     * @param record The record to fill. Reset if the slot has no chunk.
+     * @return `true` if the file was read, `false` otherwise.
+     */
+    static const bool readChunk(const std::filesystem::path &path, const unsigned int slot,
+                                std::optional<ChunkRecord> &record);
+
+    /**
+     * @brief Writes a whole region file, replacing any existing one.
+     *
+     * The file is written next to the destination and then renamed over it, so an interrupted save never leaves a
+     * truncated region behind.
+     *
+     * @param path The path to the region file.
+     * @param records The records to write, indexed by chunk slot.
+     * @return `true` if the file was written, `false` otherwise.
+     */
+    static const bool write(const std::filesystem::path &path, const RegionRecords &records);
+
+    /**
+     * @brief Writes a whole region file on a background worker, like `write`.
+     *
+     * Compression and file output happen on the worker, so the caller only pays for building the records. Records
+     * that are costly to build (e.g. deltas, which need the terrain generated again) can be left to `prepare`, which
+     * runs on the worker right before the file is written. Writes to the same file are applied in the order they were
+     * requested.
+     *
+     * @param path The path to the region file.
+     * @param records The records to write, indexed by chunk slot.
+     * @param prepare Fills in the remaining records on the worker, if set.
+     * @return A future holding whether the file was written.
+     */
+    static std::shared_future<bool> writeAsync(const std::filesystem::path &path, RegionRecords records,
+                                               std::function<void(RegionRecords &)> prepare = nullptr);
+
+    /**
+     * @brief Blocks until every background write of a file is done.
+     *
+     * @param path The path to the region file.
+     */
+    static void waitForWrites(const std::filesystem::path &path);
+
+    /**
+     * @brief Blocks until every background write is done.
+     */
+    static void waitForWrites();
+
+    /**
+     * @brief Reads an older region file into records of the current format.
+     *
+     * Tile hashes are resolved through the tile database, and hashes it doesn't know become the "unknown" tile. The
+     * file itself is left untouched: the tile ID table must be saved before the records are written back, since they
+     * may use world IDs that were just added to it.
+     *
+     * @param path The path to the region file.
+     * @param records The records to fill, indexed by chunk slot.
+     * @param tile_db The tile database to resolve the tile hashes with.
+     * @param tile_ids The tile ID table of the world.
+     * @return `true` if the file was read, `false` otherwise.
+     */
+    static const bool upgrade(const std::filesystem::path &path, RegionRecords &records, const TileDatabase &tile_db,
+                              TileIdTable &tile_ids);
+
+    /**
+     * @brief Builds the record of a chunk, dropping the unused palette entries.
+     *
+     * @param chunk The chunk to pack.
+     * @param tile_db The tile database the chunk's tile types belong to.
+     * @param tile_ids The tile ID table of the world.
+     * @return The record of the chunk.
+     */
+    static ChunkRecord pack(const Chunk &chunk, const TileDatabase &tile_db, TileIdTable &tile_ids);
+
+    /**
+     * @brief Builds the delta record of a chunk, holding only the cells that differ from its generated terrain.
+     *
+     * @param chunk The snapshot of the chunk to pack.
+     * @param generated The same chunk as the terrain generator produces it.
+     * @param tile_db The tile database the chunk's tile types belong to.
+     * @param tile_ids The tile ID table of the world.
+     * @return The delta record of the chunk.
+     */
+    static ChunkRecord packDelta(const ChunkSaveSnapshot &chunk, const Chunk &generated, const TileDatabase &tile_db,
+                                 TileIdTable &tile_ids);
+
+    /**
+     * @brief Fills a chunk from a record. A delta record only replaces the cells it changes, so the chunk must hold
+     * its generated terrain already.
+     *
+     * @param record The record to unpack.
+     * @param chunk The chunk to fill.
+     * @param tile_db The tile database to resolve the tile types from.
+     * @param tile_ids The tile ID table of the world.
+     */
+    static void unpack(const ChunkRecord &record, Chunk &chunk, const TileDatabase &tile_db,
+                       const TileIdTable &tile_ids);
+};
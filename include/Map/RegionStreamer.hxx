@@ -0,0 +1,116 @@
+/**
+ * @file RegionStreamer.hxx
+ * @brief Declares the RegionStreamer class to load and unload regions on a fixed pool of worker threads.
+ */
+
+#pragma once
+
+#include "Tools/Profiler.hxx"
+
+/**
+ * @enum RegionTaskType
+ * @brief The operations the region streamer can run on a region.
+ */
+enum class RegionTaskType : uint8_t
+{
+    Load,     ///< Load the region from disk, or generate its base terrain.
+    Decorate, ///< Run the remaining generation stages on a loaded region.
+    Unload,   ///< Release the region's chunks from memory.
+    Evict,    ///< Release the region's chunks to stay within the memory budget.
+};
+
+/**
+ * @struct RegionTask
+ * @brief A request to load or unload a region.
+ */
+struct RegionTask
+{
+    sf::Vector2i regionIndex; ///< The index of the region.
+    RegionTaskType type;      ///< The operation to run.
+    float priority;           ///< Lower values run first (e.g. the distance to the player).
+};
+
+/**
+ * @class RegionStreamer
+ * @brief Runs region loads and unloads on a fixed pool of worker threads.
+ *
+ * The owner periodically hands the streamer the whole set of operations it wants done, through `schedule`. That set
+ * replaces every request that was still waiting, so requests that became stale (e.g. a load for a region the player
+ * walked away from) are dropped without ever running. Workers always pick the request with the lowest priority value,
+ * and never run two operations on the same region at the same time, so several operations queued for one region run
+ * one after the other, in priority order.
+ */
+class RegionStreamer
+{
+  private:
+    std::function<void(const sf::Vector2i &)> loadCallback;     ///< Called by a worker to load a region.
+    std::function<void(const sf::Vector2i &)> decorateCallback; ///< Called by a worker to decorate a region.
+    std::function<void(const sf::Vector2i &)> unloadCallback;   ///< Called by a worker to unload a region.
+    std::function<void(const sf::Vector2i &)> evictCallback;    ///< Called by a worker to evict a region.
+
+    std::mutex mutex;                  ///< Guards the queue and the set of busy regions.
+    std::condition_variable condition; ///< Wakes the workers up when requests arrive or the streamer stops.
+    std::vector<RegionTask> queue;     ///< The pending requests.
+    std::vector<sf::Vector2i> busy;    ///< The regions currently being worked on.
+    bool running;                      ///< Whether the workers should keep running.
+    std::vector<std::thread> workers;  ///< The worker threads.
+
+    /**
+     * @brief The loop run by each worker thread.
+     */
+    void work();
+
+    /**
+     * @brief Checks if a region is being worked on. The caller must hold the mutex.
+     *
+     * @param region_index The index of the region.
+     * @return True if a worker is running an operation on the region.
+     */
+    const bool isBusy(const sf::Vector2i &region_index) const;
+
+  public:
+    /**
+     * @brief Constructs a RegionStreamer and starts its workers.
+     *
+     * @param load_callback The function that loads a region.
+     * @param decorate_callback The function that decorates a region.
+     * @param unload_callback The function that unloads a region.
+     * @param evict_callback The function that evicts a region.
+     * @param worker_count The amount of worker threads (0 to use one less than the amount of hardware threads).
+     */
+    RegionStreamer(std::function<void(const sf::Vector2i &)> load_callback,
+                   std::function<void(const sf::Vector2i &)> decorate_callback,
+                   std::function<void(const sf::Vector2i &)> unload_callback,
+                   std::function<void(const sf::Vector2i &)> evict_callback, unsigned int worker_count = 0);
+
+    /**
+     * @brief Stops the workers, dropping the pending requests. Operations already running are finished.
+     */
+    ~RegionStreamer();
+
+    /**
+     * @brief Replaces the pending requests.
+     *
+     * @param tasks The operations to run.
+     */
+    void schedule(std::vector<RegionTask> tasks);
+
+    /**
+     * @brief Drops every pending request.
+     */
+    void clear();
+
+    /**
+     * @brief Checks if there is no pending nor running operation.
+     *
+     * @return True if the streamer is idle.
+     */
+    const bool isIdle();
+
+    /**
+     * @brief Gets the amount of worker threads.
+     *
+     * @return The amount of workers.
+     */
+    const size_t getWorkerCount() const;
+};
@@ -8,26 +8,35 @@
 #include "Engine/Configuration.hxx"
 #include "Engine/Languages.hxx"
 #include "Map/Biome.hxx"
+#include "Map/BiomeRules.hxx"
 #include "Map/Chunk.hxx"
+#include "Map/ChunkStore.hxx"
 #include "Map/Metadata.hxx"
 #include "Tiles/TileData.hxx"
 #include "Tiles/TileDatabase.hxx"
 #include "Tools/Logger.hxx"
+#include "Tools/CounterRandom.hxx"
 #include "Tools/PerlinNoise.hxx"
+#include "Tools/Profiler.hxx"
+#include "Tools/ThreadPool.hxx"
 
 /**
- * @brief
+ * @brief The size of the playable area in regions, starting at region (0, 0).
+ *
+ * The map itself has no bounds: chunks, regions and the terrain generator accept any signed coordinates. Only what
+ * still works on a fixed grid uses the playable area: picking the spawn point, the camera, the entity spatial
+ * partition and the default range of the pregeneration tool.
  */
 static constexpr sf::Vector2u MAX_REGIONS = {16, 16};
 
 /**
- * @brief Maximum number of chunks in the world grid based on regions.
+ * @brief The size of the playable area in chunks.
  */
 static constexpr sf::Vector2u MAX_CHUNKS = {MAX_REGIONS.x * REGION_SIZE_IN_CHUNKS.x,
                                             MAX_REGIONS.y *REGION_SIZE_IN_CHUNKS.y};
 
 /**
- * @brief Maximum world grid size in tiles (based on chunks and region sizes).
+ * @brief The size of the playable area in tiles.
  */
 static constexpr sf::Vector2u MAX_WORLD_GRID_SIZE = {
     MAX_CHUNKS.x * CHUNK_SIZE_IN_TILES.x,
@@ -35,18 +44,45 @@ static constexpr sf::Vector2u MAX_WORLD_GRID_SIZE = {
 };
 
 /**
- * @brief Defines a matrix of chunks for the world.
+ * @brief The amount of chunk climates kept by the terrain generator after they were last used.
  */
-using ChunkMatrix = std::array<std::array<std::unique_ptr<Chunk>, MAX_CHUNKS.x>, MAX_CHUNKS.y>;
+static constexpr size_t CLIMATE_CACHE_SIZE = 256;
 
 /**
- * @brief Defines the biome map for the world grid.
+ * @brief The random stream used to place decorations (grass, bushes, snow) on top of the base tiles.
  */
-using BiomeMap = std::array<std::array<BiomePreset, MAX_WORLD_GRID_SIZE.y>, MAX_WORLD_GRID_SIZE.x>;
+static constexpr uint32_t DECORATION_RANDOM_CHANNEL = 0;
+
+/**
+ * @struct ChunkClimate
+ * @brief The height, moisture, heat and biome of every tile column of a chunk.
+ */
+struct ChunkClimate
+{
+    NoiseMap heights{CHUNK_SIZE_IN_TILES.x, CHUNK_SIZE_IN_TILES.y};   ///< Height of each column.
+    NoiseMap moistures{CHUNK_SIZE_IN_TILES.x, CHUNK_SIZE_IN_TILES.y}; ///< Moisture of each column.
+    NoiseMap heats{CHUNK_SIZE_IN_TILES.x, CHUNK_SIZE_IN_TILES.y};     ///< Heat of each column.
+    std::array<BiomeId, CHUNK_AREA> biomes;                           ///< Biome of each column, row-major.
+    std::array<sf::Color, CHUNK_AREA> tints;                          ///< Biome tint of each column, row-major.
+};
+
+/**
+ * @struct Decoration
+ * @brief A decoration rule resolved against the tile database, as used by the decoration stage.
+ */
+struct Decoration
+{
+    const TileData *tile; ///< The decoration tile.
+    float threshold;      ///< Random values below this (and above the previous decoration's) place the tile.
+    uint8_t z;            ///< Layer the decoration is placed on.
+};
 
 /**
  * @class TerrainGenerator.
  * @brief Class responsible for terrain generation in the world grid.
+ *
+ * Every generated value is a pure function of the seed and the grid position, so chunks can be generated in any
+ * order, and memory only grows with the area that was recently generated, not with the size of the world.
  */
 class TerrainGenerator
 {
@@ -55,99 +91,168 @@ class TerrainGenerator
     std::string &msg;   ///< String to store messages for reporting progress.
     Metadata &metadata; ///< Metadata related to world generation.
 
-    ChunkMatrix &chunks;      ///< Matrix storing chunks of the world.
-    long int seed;            ///< Seed for random number generation and Perlin noise.
-    sf::Texture &texturePack; ///< Texture pack for tile rendering.
-    TileDatabase &tileDb;     ///< Tile database mapping tile tags to tile data.
-    float scale;              ///< Scale for terrain generation.
+    ChunkStore &chunks;           ///< Resident chunks of the world.
+    long int seed;                ///< Seed for random number generation and Perlin noise.
+    sf::Texture &texturePack;     ///< Texture pack for tile rendering.
+    TileDatabase &tileDb;         ///< Tile database mapping tile tags to tile data.
+    const BiomeRules &biomeRules; ///< Data-driven tiles of every biome, compiled by `initBiomes`.
+    float scale;                  ///< Scale for terrain generation.
 
-    Random rng;                      ///< Linear-Congruential pseudo-random number generator.
+    CounterRandom rng;               ///< Stateless random values for terrain features, by position.
     PerlinNoise perlinNoise;         ///< Perlin noise generator for terrain features.
     std::vector<Wave> heightWaves;   ///< Waves for heightmap generation.
     std::vector<Wave> moistureWaves; ///< Waves for moisture map generation.
     std::vector<Wave> heatWaves;     ///< Waves for heatmap generation.
-    NoiseMap heightMap;              ///< Height map of the world.
-    NoiseMap moistureMap;            ///< Moisture map of the world.
-    NoiseMap heatMap;                ///< Heat map of the world.
 
-    std::vector<Biome> biomes;                  ///< List of biomes available for the world.
-    BiomeMap biomeMap;                          ///< Map of biomes for the world grid.
-    std::vector<std::vector<float>> randomGrid; ///< Precomputed random values for the entire world.
+    std::vector<Biome> biomes;                                         ///< List of biomes available for the world.
+    std::vector<BiomePreset> biomePresets;                             ///< Shared preset of every biome, by biome ID.
+    std::array<std::vector<Decoration>, BIOME_TYPE_COUNT> decorations; ///< Decorations of every biome, by biome ID.
+
+    using ClimateCache = std::list<std::pair<uint64_t, std::shared_ptr<const ChunkClimate>>>;
+
+    std::mutex climateMutex;                                           ///< Guards the climate cache.
+    ClimateCache climateCache;                                         ///< Cached climates, most recent first.
+    std::unordered_map<uint64_t, ClimateCache::iterator> climateIndex; ///< Cache entries, by packed chunk index.
 
     /// Initializes Perlin noise waves for height, moisture, and heat.
     void initPerlinWaves();
 
-    /// Initializes noise maps (height, moisture, heat) for the world grid.
-    void initNoiseMaps();
-
-    /// Initializes the list of biomes and precomputes biome data.
+    /// Initializes the list of biomes, and compiles their rules into presets and decoration tables.
     void initBiomes();
 
-    /// Initializes a grid of random values used for world generation.
-    void initRandomGrid();
+    /// Computes the climate of a chunk from the noise functions.
+    std::shared_ptr<const ChunkClimate> computeClimate(const sf::Vector2i &chunk_index) const;
+
+    /// Computes the tint of a biome for the given moisture and heat.
+    const sf::Color computeTint(const BiomeId &biome_id, const float &moisture, const float &heat) const;
+
+    /// Surface stage: places the base tile of every column and tints it.
+    void generateSurface(Chunk &chunk, const ChunkClimate &climate);
 
-    /// Places a tile in the world grid at the specified position.
-    void putTile(Tile tile, const int &grid_x, const int &grid_y, const int &grid_z);
+    /// Decoration stage: places the decorations of each biome on top of the surface.
+    void generateDecorations(Chunk &chunk, const ChunkClimate &climate);
 
-    /// Retrieves the tile at the specified grid position.
-    Tile *getTile(const int &grid_x, const int &grid_y, const int &grid_z);
+    /// Retrieves a view of the tile at the specified grid position.
+    std::optional<Tile> getTile(const int &grid_x, const int &grid_y, const int &grid_z);
 
   public:
     /**
      * @brief Constructor for TerrainGenerator.
      *
-     * Initializes the terrain generation system, including Perlin noise, biome map, and noise maps.
+     * Only the noise waves and the biome list are set up here. Noise, biomes and decorations are evaluated per chunk
+     * when a region is generated, and recently used chunks are cached.
      *
      * @param msg Reference to a string for storing messages.
      * @param metadata Metadata related to world generation.
-     * @param chunks Chunk matrix to store world chunks.
+     * @param chunks Chunk store to put the generated chunks in.
      * @param seed Seed for random number generation and Perlin noise.
      * @param texture_pack Reference to the texture pack for tile rendering.
      * @param tile_db Reference to the tile database.
+     * @param biome_rules Reference to the generation rules of the biomes.
      * @param scale Scale factor for terrain generation.
      */
-    TerrainGenerator(std::string &msg, Metadata &metadata, ChunkMatrix &chunks, long int seed,
-                     sf::Texture &texture_pack, TileDatabase &tile_db, const float &scale);
+    TerrainGenerator(std::string &msg, Metadata &metadata, ChunkStore &chunks, long int seed,
+                     sf::Texture &texture_pack, TileDatabase &tile_db, const BiomeRules &biome_rules,
+                     const float &scale);
 
     /// Destructor for TerrainGenerator.
     ~TerrainGenerator();
 
     /**
-     * @brief Generates terrain for a specific region in the world.
+     * @brief Generates terrain for a specific region in the world, up to a stage of the pipeline.
+     *
+     * Missing chunks are created, and every chunk that is behind `target` is advanced stage by stage. The stages run
+     * stage-major: every chunk of the region finishes a stage before any chunk starts the next one, so a stage can
+     * rely on its neighbours inside the region being at least one stage behind. Meshes are updated once, at the
+     * end. Chunks without unsaved changes before the call are still considered saved afterwards.
+     *
+     * The stages run on copies of the resident chunks, which replace them once finished, so readers never see a
+     * chunk half-way through a stage. A chunk edited in the meantime (see `ChunkStore::edit`) is copied again.
+     *
+     * The caller must have exclusive access to the region.
      *
      * @param region_index The index of the region to generate (x, y).
+     * @param target The status every chunk of the region should reach.
+     */
+    void generateRegion(const sf::Vector2i &region_index, const ChunkStatus target = ChunkStatus::Complete);
+
+    /**
+     * @brief Generates several regions in parallel, reporting the progress through the loading message.
+     *
+     * Each region is generated by a single worker, and every generated value only depends on the seed and the grid
+     * position, so the result is identical to generating the regions one by one, for any amount of threads.
+     *
+     * @param region_indexes The indexes of the regions to generate. Must not hold duplicates.
+     * @param target The status every chunk of the regions should reach.
+     * @param thread_count The amount of worker threads (0 to use every hardware thread).
+     */
+    void generateRegions(const std::vector<sf::Vector2i> &region_indexes,
+                         const ChunkStatus target = ChunkStatus::Complete, const unsigned int thread_count = 0);
+
+    /**
+     * @brief Generates a chunk outside of the world, e.g. to compare a chunk with the terrain it was generated with.
+     *
+     * The chunk goes through every stage, exactly like the chunks of `generateRegion`, but its mesh is never built.
+     * Safe to call from any thread.
+     *
+     * @param chunk_index The index of the chunk.
+     * @return The generated chunk.
+     */
+    std::unique_ptr<Chunk> generateChunk(const sf::Vector2i &chunk_index);
+
+    /**
+     * @brief Gets the climate of a chunk, from the cache or computed on demand. Safe to call from any thread.
+     *
+     * @param chunk_index The index of the chunk.
+     * @return The climate of the chunk.
+     */
+    std::shared_ptr<const ChunkClimate> getClimate(const sf::Vector2i &chunk_index);
+
+    /**
+     * @brief Gets the index of the chunk holding a grid position, rounding towards negative infinity.
+     *
+     * @param grid_pos The position (x, y) on the world grid. May be negative.
+     * @return The index of the chunk.
+     */
+    static const sf::Vector2i getChunkIndex(const sf::Vector2i &grid_pos);
+
+    /**
+     * @brief Gets the position of a grid position inside its chunk.
+     *
+     * @param grid_pos The position (x, y) on the world grid. May be negative.
+     * @return The position inside the chunk, from 0 to the chunk size.
      */
-    void generateRegion(const sf::Vector2i &region_index);
+    static const sf::Vector2u getTileIndex(const sf::Vector2i &grid_pos);
 
     /**
      * @brief Retrieves the biome data for a specific grid position.
      *
      * @param grid_pos The position (x, y) on the world grid.
-     * @return const BiomePreset& The biome data at the specified grid position.
+     * @return const BiomePreset The biome data at the specified grid position.
      */
-    const BiomePreset &getBiomeData(const sf::Vector2i &grid_pos) const;
+    const BiomePreset getBiomeData(const sf::Vector2i &grid_pos);
 
     /**
      * @brief Retrieves the height value at a specific grid position.
      *
      * @param grid_pos The position (x, y) on the world grid.
-     * @return const float& The height value at the specified grid position.
+     * @return const float The height value at the specified grid position.
      */
-    const float &getHeightAt(const sf::Vector2i &grid_pos) const;
+    const float getHeightAt(const sf::Vector2i &grid_pos);
 
     /**
      * @brief Retrieves the moisture value at a specific grid position.
      *
      * @param grid_pos The position (x, y) on the world grid.
-     * @return const float& The moisture value at the specified grid position.
+     * @return const float The moisture value at the specified grid position.
      */
-    const float &getMoistureAt(const sf::Vector2i &grid_pos) const;
+    const float getMoistureAt(const sf::Vector2i &grid_pos);
 
     /**
      * @brief Retrieves the heat value at a specific grid position.
      *
      * @param grid_pos The position (x, y) on the world grid.
-     * @return const float& The heat value at the specified grid position.
+     * @return const float The heat value at the specified grid position.
      */
-    const float &getHeatAt(const sf::Vector2i &grid_pos) const;
+    const float getHeatAt(const sf::Vector2i &grid_pos);
 };
@@ -0,0 +1,116 @@
+/**
+ * @file TileIdTable.hxx
+ * @brief Declares the TileIdTable class to map the tile types of a world to small, stable IDs.
+ */
+
+#pragma once
+
+#include "Engine/Languages.hxx"
+#include "Tiles/TileDatabase.hxx"
+#include "Tools/JSON.hxx"
+#include "Tools/Logger.hxx"
+
+/**
+ * @brief The name of the file holding the tile ID table of a world, next to its metadata.
+ */
+static const std::string TILE_ID_TABLE_FILENAME = "tile_ids.json";
+
+/**
+ * @brief The current version of the tile ID table file.
+ */
+static constexpr long long TILE_ID_TABLE_VERSION = 1;
+
+/**
+ * @typedef WorldTileId
+ * @brief The ID of a tile type inside a world, as stored in its region files.
+ */
+using WorldTileId = uint16_t;
+
+/**
+ * @class TileIdTable
+ * @brief Maps the tile tags used by a world to small IDs that are stable for the lifetime of the world.
+ *
+ * Region files store these world IDs instead of a hash of the tag, so they don't depend on how a standard library
+ * hashes strings, and a world can be moved between builds and machines. The table is saved as a JSON array of tags
+ * next to the world metadata, where the index of a tag is its world ID. Tags are only ever appended, and tags the
+ * current tile database doesn't know are kept, so no mapping is ever lost.
+ *
+ * World IDs are remapped to the runtime IDs of the tile database once, when the table is loaded or grows.
+ *
+ * All methods are thread safe.
+ */
+class TileIdTable
+{
+  private:
+    mutable std::mutex mutex; ///< Guards the table, since regions are loaded and saved from worker threads.
+
+    Logger logger; ///< Logger for logging information and errors.
+
+    std::vector<std::string> tags;                         ///< Tags of the tile types, indexed by world ID.
+    std::unordered_map<std::string, WorldTileId> worldIds; ///< World IDs, indexed by tag.
+    std::vector<TileId> runtimeIds;                        ///< Runtime IDs, indexed by world ID.
+    std::vector<WorldTileId> worldIdsByRuntimeId;          ///< World IDs, indexed by runtime ID (or invalid).
+    bool modified;                                         ///< Whether the table changed since it was saved.
+
+    /**
+     * @brief Appends a tag to the table. The caller must hold the mutex.
+     *
+     * @param tag The tag to append.
+     * @param tile_db The tile database to resolve the runtime ID with.
+     * @return The world ID of the tag.
+     */
+    const WorldTileId append(const std::string &tag, const TileDatabase &tile_db);
+
+  public:
+    /**
+     * @brief Constructs an empty TileIdTable. The "unknown" tile always gets the world ID 0.
+     */
+    TileIdTable();
+
+    /**
+     * @brief Destructor for the TileIdTable class.
+     */
+    ~TileIdTable();
+
+    /**
+     * @brief Replaces the table with the one saved in a file.
+     *
+     * @param path The path to the table file.
+     * @param tile_db The tile database to remap the world IDs to.
+     * @return `true` if the table was loaded, `false` otherwise.
+     */
+    const bool load(const std::filesystem::path &path, const TileDatabase &tile_db);
+
+    /**
+     * @brief Saves the table to a file, through a temporary file renamed over it.
+     *
+     * @param path The path to the table file.
+     * @return `true` if the table was saved, `false` otherwise.
+     */
+    const bool save(const std::filesystem::path &path);
+
+    /**
+     * @brief Gets the world ID of a tile type, adding it to the table if needed.
+     *
+     * @param data The tile type.
+     * @param tile_db The tile database the tile type belongs to.
+     * @return The world ID of the tile type.
+     */
+    const WorldTileId getWorldId(const TileData &data, const TileDatabase &tile_db);
+
+    /**
+     * @brief Gets the tile type of a world ID.
+     *
+     * @param world_id The world ID.
+     * @param tile_db The tile database to resolve the tile type from.
+     * @return The tile type, or the "unknown" tile if the world ID or its tag is unknown.
+     */
+    const TileData &getTileData(const WorldTileId &world_id, const TileDatabase &tile_db) const;
+
+    /**
+     * @brief Checks if the table changed since it was last loaded or saved.
+     *
+     * @return True if the table needs to be saved.
+     */
+    const bool isModified() const;
+};
@@ -20,6 +20,7 @@
 #include "Network/Server.hxx"
 #include "Player/PlayerGUI.hxx"
 #include "States/State.hxx"
+#include "Tools/Profiler.hxx"
 #include "Tools/UUID.hxx"
 #include "Engine/Languages.hxx"
 
@@ -144,6 +145,12 @@ class GameState : public State
 
     void handleTileMining();
 
+    /**
+     * @brief Exports the zones recorded by the frame profiler to a Chrome trace in the traces folder, and reports the
+     * result in the chat.
+     */
+    void exportProfilerTrace();
+
   public:
     /**
      * @brief Constructor that initializes the game state with given engine data.
@@ -169,6 +176,12 @@ class GameState : public State
      */
     void update(const float &dt);
 
+    /**
+     * @brief Advances the simulation by one tick: moves the entities and players and resolves their collisions.
+     * @param dt The duration of a tick.
+     */
+    void fixedUpdate(const float &dt);
+
     /**
      * @brief Updates the pause menu.
      * @param dt The delta time for the frame update.
@@ -183,13 +196,13 @@ class GameState : public State
 
     /**
      * @brief Updates global entities in the game world.
-     * @param dt The delta time for the frame update.
+     * @param dt The duration of a simulation tick.
      */
     void updateGlobalEntities(const float &dt);
 
     /**
      * @brief Updates all players in the game.
-     * @param dt The delta time for the frame update.
+     * @param dt The duration of a simulation tick.
      */
     void updatePlayers(const float &dt);
 
@@ -200,7 +213,7 @@ class GameState : public State
 
     /**
      * @brief Updates collisions between entities.
-     * @param dt The delta time for the frame update.
+     * @param dt The duration of a simulation tick.
      */
     void updateCollisions(const float &dt);
 
@@ -59,11 +59,17 @@ class State
     virtual ~State();
 
     /**
-     * @brief Updates the current state, including logic and input handling.
+     * @brief Updates the current state once per frame, including input handling and the user interface.
      * @param dt The delta time (time elapsed since the last update).
      */
     virtual void update(const float &dt);
 
+    /**
+     * @brief Advances the simulation of the state by one tick. Runs at a fixed rate, independent of the framerate.
+     * @param dt The duration of a tick.
+     */
+    virtual void fixedUpdate(const float &dt);
+
     /**
      * @brief Renders the current state to the provided render target.
      * @param target The target render object to draw the state elements.
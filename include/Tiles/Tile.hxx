@@ -11,8 +11,8 @@
  * @class Tile
  * @brief A class representing a tile in a tile-based system.
  *
- * The `Tile` class is a derived class from `TileBase`, adding additional functionality for positioning and rendering
- * tiles in a grid-based environment.
+ * The `Tile` class is a derived class from `TileBase`. It is a lightweight view over a cell of a chunk, created on
+ * demand by the map when a tile is queried.
  */
 class Tile : public TileBase
 {
@@ -20,39 +20,18 @@ class Tile : public TileBase
     /**
      * @brief Constructs a new Tile object.
      *
-     * This constructor initializes a tile with specific attributes, such as its name, tag, texture, position in the
-     * grid, and visual properties like scale and color.
+     * This constructor initializes a tile view with the data of its type, its position in the grid, and visual
+     * properties like scale and color.
      *
-     * @param name The name of the tile.
-     * @param tag The tag of the tile.
-     * @param id The unique identifier of the tile.
-     * @param texture The texture to use for the tile.
-     * @param texture_rect The rectangle on the texture to use for the tile.
+     * @param data The shared data of the tile type.
      * @param grid_position The position of the tile in the grid.
+     * @param layer The z layer of the tile.
      * @param scale The scale factor for the tile.
      * @param color The color of the tile (defaults to white).
      */
-    Tile(const std::string name, const std::string &tag, const uint64_t &id, sf::Texture &texture,
-         const sf::IntRect &texture_rect, const sf::Vector2i &grid_position, const unsigned int &scale,
+    Tile(const TileData &data, const sf::Vector2i &grid_position, const unsigned int &layer, const float &scale,
          const sf::Color &color = sf::Color::White);
 
-    /**
-     * @brief Constructs a new Tile object.
-     *
-     * This constructor initializes a tile with specific attributes, such as its name, tag, texture, position in the
-     * grid, and visual properties like scale and color.
-     *
-     * @param name The name of the tile.
-     * @param tag The tag of the tile.
-     * @param id The unique identifier of the tile.
-     * @param texture The texture to use for the tile.
-     * @param texture_rect The rectangle on the texture to use for the tile.
-     * @param scale The scale factor for the tile.
-     * @param color The color of the tile (defaults to white).
-     */
-    Tile(const std::string name, const std::string &tag, const uint64_t &id, sf::Texture &texture,
-         const sf::IntRect &texture_rect, const unsigned int &scale, const sf::Color &color = sf::Color::White);
-
     /**
      * @brief Destroys the Tile object.
      *
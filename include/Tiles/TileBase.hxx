@@ -14,50 +14,56 @@ constexpr int QUAD_VERTEX_COUNT = 6;
  * @class TileBase
  * @brief A base class representing a tile in the game world.
  *
- * This class provides common properties and methods for handling tiles, such as
- * texture, position, grid positioning, and rendering. The tile is drawn as a sprite
- * with a specified texture and can be manipulated using the available methods.
+ * Chunks store their tiles as a compact palette-indexed cell array, and a `TileBase` is only a lightweight view
+ * over one of those cells. It references the shared `TileData` of its type and carries the cell position, layer and
+ * tint, so it is cheap to create and copy on demand.
  */
-class TileBase : public sf::Drawable, public sf::Transformable
+class TileBase
 {
-  private:
-    /**
-     * @brief Draws the tile into a render target.
-     *
-     * @param target The target to which the tile will be rendered.
-     * @param states The render states.
-     */
-    void draw(sf::RenderTarget &target, sf::RenderStates states = sf::RenderStates::Default) const override;
-
   protected:
-    std::string name;         ///< The name of the tile.
-    std::string tag;          ///< The tag of the tile in the format `domain:name`.
-    uint64_t id;              ///< The unique identifier of the tile.
-    sf::Texture &texture;     ///< The texture used for rendering the tile.
-    sf::IntRect textureRect;  ///< The portion of the texture to use for the tile.
-    sf::VertexArray vertices; ///< The render vertices of the tile.
-    float scaleScalar;        ///< The scale used in the game.
+    const TileData *data;      ///< The shared data of the tile type. Never null.
+    sf::Vector2i gridPosition; ///< The position of the tile in the world grid (in grid units).
+    unsigned int layer;        ///< The z layer of the tile inside its chunk.
+    sf::Color color;           ///< The tint applied to the tile.
+    float scaleScalar;         ///< The scale used in the game.
 
   public:
     /**
      * @brief Construct a new TileBase object.
      *
-     * @param name The name of the tile.
-     * @param tag The tag of the tile, in the format `domain:name`.
-     * @param id The unique identifier of the tile.
-     * @param texture The texture to be used for the tile.
-     * @param texture_rect The portion of the texture to be used.
-     * @param grid_position The grid position of the tile
+     * @param data The shared data of the tile type.
+     * @param grid_position The grid position of the tile.
+     * @param layer The z layer of the tile.
      * @param scale The scale factor for the tile (default is 1.f).
+     * @param color The tint of the tile (default is white).
      */
-    TileBase(const std::string &name, const std::string &tag, const uint64_t &id, sf::Texture &texture,
-             const sf::IntRect &texture_rect, const sf::Vector2i &grid_position, const float &scale = 1.f);
+    TileBase(const TileData &data, const sf::Vector2i &grid_position, const unsigned int &layer,
+             const float &scale = 1.f, const sf::Color &color = sf::Color::White);
 
     /**
      * @brief Destroy the TileBase object.
      */
     virtual ~TileBase();
 
+    /**
+     * @brief Writes the two triangles of a tile quad into a vertex buffer.
+     *
+     * @param quad Pointer to the first of `QUAD_VERTEX_COUNT` vertices to write.
+     * @param grid_position The grid position of the tile.
+     * @param scale The scale factor for the tile.
+     * @param texture_rect The portion of the texture to be used.
+     * @param color The tint of the tile.
+     */
+    static void writeQuad(sf::Vertex *quad, const sf::Vector2i &grid_position, const float &scale,
+                          const sf::IntRect &texture_rect, const sf::Color &color);
+
+    /**
+     * @brief Get the shared data of the tile type.
+     *
+     * @return The data of the tile type.
+     */
+    const TileData &getData() const;
+
     /**
      * @brief Get the name of the tile.
      *
@@ -77,7 +83,7 @@ class TileBase : public sf::Drawable, public sf::Transformable
      *
      * @return The unique id of the tile.
      */
-    const uint64_t &getId() const;
+    const TileId &getId() const;
 
     /**
      * @brief Get the position of the tile.
@@ -91,7 +97,14 @@ class TileBase : public sf::Drawable, public sf::Transformable
      *
      * @return The grid position of the tile.
      */
-    const sf::Vector2u getGridPosition() const;
+    const sf::Vector2i getGridPosition() const;
+
+    /**
+     * @brief Get the z layer of the tile.
+     *
+     * @return The layer of the tile.
+     */
+    const unsigned int &getLayer() const;
 
     /**
      * @brief Get the color of the tile.
@@ -113,32 +126,4 @@ class TileBase : public sf::Drawable, public sf::Transformable
      * @return The center position of the tile.
      */
     const sf::Vector2f getCenter() const;
-
-    /**
-     * @brief Returns the `sf::VertexArray` reference of the tile.
-     *
-     * @return The `sf::VertexArray` reference of the tile.
-     */
-    const sf::VertexArray &getVertexArray() const;
-
-    /**
-     * @brief Set the position of the tile.
-     *
-     * @param position The new position for the tile.
-     */
-    void setPosition(const sf::Vector2f &position);
-
-    /**
-     * @brief Set the grid position of the tile (in grid units).
-     *
-     * @param position The new grid position for the tile.
-     */
-    void setGridPosition(const sf::Vector2u &position);
-
-    /**
-     * @brief Set the color of the tile.
-     *
-     * @param color The new color for the tile.
-     */
-    void setColor(const sf::Color &color);
 };
@@ -7,6 +7,20 @@
 
 #include "stdafx.hxx"
 
+/**
+ * @typedef TileId
+ * @brief A dense, sequential tile type identifier, assigned in the order tile types are loaded.
+ *
+ * IDs index directly into the tile database. They are only meaningful while the game is running and must not be
+ * written to disk.
+ */
+using TileId = uint16_t;
+
+/**
+ * @brief The ID of the "unknown" tile type, which is always the first one loaded.
+ */
+static constexpr TileId UNKNOWN_TILE_ID = 0;
+
 /**
  * @struct TileData
  * @brief A structure that holds data for a tile.
@@ -26,10 +40,16 @@ struct TileData
     /**
      * @brief The unique id of the tile.
      *
-     * This is a 8 bytes long number used to uniquely identify each tile. The id is automatically
-     * calculated by the hash of the tag.
+     * This is the dense index of the tile type inside the tile database.
+     */
+    TileId id;
+
+    /**
+     * @brief The hash of the tag of the tile.
+     *
+     * This is a 8 bytes long number calculated from the tag. It is the tile identifier stored in region files.
      */
-    uint64_t id;
+    uint64_t hash;
 
     /**
      * @brief The name of the tile.
@@ -13,20 +13,26 @@
  * @brief Manages a database of tile data.
  *
  * This class is responsible for storing and retrieving tile data, including tile tags, names, and texture rectangles.
- * It provides methods to insert new tiles and retrieve them by tag or ID.
+ * It provides methods to insert new tiles and retrieve them by tag, ID or hash.
+ *
+ * Tile types get dense, sequential IDs in insertion order, so retrieving a tile type by ID is a plain index. The
+ * tile data is never moved once inserted, so references returned by the database can be kept as handles for as long
+ * as the database is alive.
  */
 class TileDatabase
 {
   private:
-    std::hash<std::string> hash_function; ///< Hash function for generating tile IDs.
+    std::hash<std::string> hash_function; ///< Hash function for generating tile hashes.
 
-    std::unordered_map<std::string, TileData> db; ///< Database of tile data, indexed by tile tags.
+    std::deque<TileData> tiles;                       ///< Data of every tile type, indexed by tile ID.
+    std::unordered_map<std::string, TileId> tagIndex; ///< Tile IDs, indexed by tile tags.
+    std::unordered_map<uint64_t, TileId> hashIndex;   ///< Tile IDs, indexed by tile hashes.
 
   public:
     /**
      * @brief Constructs a TileDatabase object.
      *
-     * Initializes the database with a default "unknown" tile.
+     * Initializes the database with a default "unknown" tile, which gets `UNKNOWN_TILE_ID`.
      */
     TileDatabase();
 
@@ -38,6 +44,8 @@ class TileDatabase
     /**
      * @brief Inserts a new tile into the database.
      *
+     * Inserting a tag that already exists updates its data in place and keeps its ID.
+     *
      * @param tag The unique tag for the tile.
      * @param name The name of the tile.
      * @param rect_index_x The x-coordinate index of the tile's texture rectangle.
@@ -51,15 +59,41 @@ class TileDatabase
      * @brief Retrieves tile data by its tag.
      *
      * @param tag The tag of the tile to retrieve.
-     * @return The TileData object corresponding to the tag. If the tag is not found, returns the "unknown" tile data.
+     * @return A reference to the TileData corresponding to the tag. If the tag is not found, returns the "unknown"
+     * tile data. The reference stays valid as long as the database is alive.
      */
-    const TileData getByTag(const std::string &tag);
+    const TileData &getByTag(const std::string &tag) const;
+
+    /**
+     * @brief Retrieves the ID of a tile by its tag.
+     *
+     * @param tag The tag of the tile.
+     * @return The ID of the tile, or `UNKNOWN_TILE_ID` if the tag is not found.
+     */
+    const TileId getIdByTag(const std::string &tag) const;
 
     /**
      * @brief Retrieves tile data by its ID.
      *
      * @param id The ID of the tile to retrieve.
-     * @return The TileData object corresponding to the ID. If the ID is not found, returns the "unknown" tile data.
+     * @return A reference to the TileData corresponding to the ID. If the ID is not found, returns the "unknown"
+     * tile data. The reference stays valid as long as the database is alive.
+     */
+    const TileData &getById(const TileId &id) const;
+
+    /**
+     * @brief Retrieves tile data by the hash of its tag.
+     *
+     * @param hash The hash of the tile to retrieve.
+     * @return A reference to the TileData corresponding to the hash. If the hash is not found, returns the "unknown"
+     * tile data. The reference stays valid as long as the database is alive.
+     */
+    const TileData &getByHash(const uint64_t &hash) const;
+
+    /**
+     * @brief Gets the amount of tile types in the database, "unknown" included.
+     *
+     * @return The amount of tile types.
      */
-    const TileData getById(const uint64_t &id);
+    const size_t getCount() const;
 };
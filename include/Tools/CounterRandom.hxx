@@ -0,0 +1,94 @@
+/**
+ * @file CounterRandom.hxx
+ * @brief Declares the CounterRandom class, a stateless random number generator indexed by coordinates.
+ */
+
+#pragma once
+
+/**
+ * @class CounterRandom
+ * @brief A counter-based random number generator: every value is a hash of the seed, a position and a channel.
+ *
+ * Unlike `Random`, there is no state to advance, so values can be drawn in any order and from any thread, and a
+ * position always gets the same value. Channels give independent streams for the same position (e.g. one per
+ * decorator), so features don't end up correlated.
+ *
+ * The hash only uses 32-bit operations, so loops over `getUInt` and `fillRow` vectorize.
+ */
+class CounterRandom
+{
+  private:
+    uint32_t key0; ///< First half of the key derived from the seed.
+    uint32_t key1; ///< Second half of the key derived from the seed.
+
+    /**
+     * @brief Mixes the bits of a 32-bit value (lowbias32 finalizer).
+     *
+     * @param value The value to mix.
+     * @return The mixed value.
+     */
+    static uint32_t mix(uint32_t value)
+    {
+        value ^= value >> 16;
+        value *= 0x7FEB352Du;
+        value ^= value >> 15;
+        value *= 0x846CA68Bu;
+        value ^= value >> 16;
+        return value;
+    }
+
+  public:
+    /**
+     * @brief Constructs a CounterRandom from a seed.
+     *
+     * @param seed The seed of the generator.
+     */
+    CounterRandom(const long long int &seed);
+
+    /**
+     * @brief Destructor for the CounterRandom class.
+     */
+    ~CounterRandom();
+
+    /**
+     * @brief Gets the random 32-bit value of a position.
+     *
+     * @param x The x-coordinate.
+     * @param y The y-coordinate.
+     * @param channel The stream to draw from.
+     * @return A uniformly distributed 32-bit value.
+     */
+    uint32_t getUInt(const int x, const int y, const uint32_t channel) const
+    {
+        uint32_t hash = mix(static_cast<uint32_t>(x) ^ key0);
+        hash = mix(hash ^ static_cast<uint32_t>(y) * 0x9E3779B9u);
+        hash = mix(hash ^ (channel + key1));
+
+        return hash;
+    }
+
+    /**
+     * @brief Gets the random floating-point value of a position.
+     *
+     * @param x The x-coordinate.
+     * @param y The y-coordinate.
+     * @param channel The stream to draw from.
+     * @return A random value in the range [0, 1).
+     */
+    float getFloat(const int x, const int y, const uint32_t channel) const
+    {
+        // The top 24 bits fill a float's mantissa exactly.
+        return static_cast<float>(getUInt(x, y, channel) >> 8) * (1.f / 16777216.f);
+    }
+
+    /**
+     * @brief Gets the random floating-point values of a row of positions, like calling `getFloat` for each.
+     *
+     * @param x The x-coordinate of the first position. Position `i` is at `x + i`.
+     * @param y The y-coordinate of the row.
+     * @param count The amount of positions.
+     * @param channel The stream to draw from.
+     * @param values The array to write the `count` values to.
+     */
+    void fillRow(const int x, const int y, const unsigned int count, const uint32_t channel, float *values) const;
+};
@@ -0,0 +1,124 @@
+/**
+ * @file EpochReclaimer.hxx
+ * @brief Declares the EpochReclaimer class to free shared objects once no reader can still be using them.
+ */
+
+#pragma once
+
+/**
+ * @class EpochReclaimer
+ * @brief Epoch-based reclamation of objects that are read without locks.
+ *
+ * Readers pin the current epoch for as long as they use the objects they found, which only costs a few atomic
+ * operations and never waits. Writers unpublish an object first (so no new reader can find it), then retire it: the
+ * object is tagged with the current epoch and destroyed later, once every reader that could have found it is gone.
+ *
+ * Readers are counted per epoch parity, so only two epochs can have readers at once. The epoch only advances when
+ * nobody is pinned in the previous one, and an object retired in epoch `e` is destroyed once the epoch reached
+ * `e + 2`: every reader pinned in `e` or earlier has left by then. A reader that stays pinned only delays the
+ * destruction of retired objects, it never blocks a writer.
+ */
+class EpochReclaimer
+{
+  public:
+    /**
+     * @class Guard
+     * @brief Keeps an epoch pinned while alive. Objects found while holding it stay valid until it is destroyed.
+     */
+    class Guard
+    {
+      private:
+        const EpochReclaimer *owner; ///< The reclaimer the epoch is pinned in, or `nullptr` once moved from.
+        uint64_t epoch;              ///< The pinned epoch.
+
+      public:
+        /**
+         * @brief Pins the current epoch of a reclaimer.
+         *
+         * @param reclaimer The reclaimer.
+         */
+        Guard(const EpochReclaimer &reclaimer);
+
+        /**
+         * @brief Takes over the epoch pinned by another guard.
+         *
+         * @param other The guard to move from.
+         */
+        Guard(Guard &&other) noexcept;
+
+        Guard(const Guard &) = delete;
+        Guard &operator=(const Guard &) = delete;
+        Guard &operator=(Guard &&) = delete;
+
+        /**
+         * @brief Unpins the epoch.
+         */
+        ~Guard();
+    };
+
+  private:
+    /**
+     * @struct Retired
+     * @brief An object waiting to be destroyed.
+     */
+    struct Retired
+    {
+        uint64_t epoch;                ///< The epoch the object was retired in.
+        std::function<void()> deleter; ///< Destroys the object.
+    };
+
+    std::atomic_uint64_t epoch;                         ///< The current epoch.
+    mutable std::array<std::atomic_uint64_t, 2> active; ///< Pinned readers, by epoch parity.
+
+    std::mutex retiredMutex;      ///< Guards the retired objects. Only writers and `reclaim` take it.
+    std::vector<Retired> retired; ///< Objects waiting for their readers to leave, oldest first.
+
+    /**
+     * @brief Advances the epoch if possible, and destroys the objects no reader can reach anymore. The caller must
+     * hold `retiredMutex`.
+     */
+    void collect();
+
+  public:
+    /**
+     * @brief Constructs an EpochReclaimer with nothing retired.
+     */
+    EpochReclaimer();
+
+    /**
+     * @brief Destroys every retired object. No reader may be pinned anymore.
+     */
+    ~EpochReclaimer();
+
+    /**
+     * @brief Pins the current epoch. Lock-free, and safe to nest.
+     *
+     * @return The guard keeping the epoch pinned.
+     */
+    Guard pin() const;
+
+    /**
+     * @brief Hands an object over to be destroyed once no reader can be using it. The object must already be
+     * unreachable for new readers.
+     *
+     * @param object The object to destroy. Does nothing for `nullptr`.
+     */
+    template <typename T> void retire(T *object)
+    {
+        if (object)
+            retire([object]() { delete object; });
+    }
+
+    /**
+     * @brief Hands a deleter over to be run once no reader can be using what it destroys.
+     *
+     * @param deleter The function destroying the object.
+     */
+    void retire(std::function<void()> deleter);
+
+    /**
+     * @brief Destroys the retired objects no reader can reach anymore. Never waits: does nothing if a writer is
+     * retiring an object at the same time, since it collects right after.
+     */
+    void reclaim();
+};
@@ -0,0 +1,116 @@
+/**
+ * @file NoiseMap.hxx
+ * @brief Declares the NoiseMap class, a contiguous 2D grid of noise values.
+ */
+
+#pragma once
+
+/**
+ * @class NoiseMap
+ * @brief A 2D grid of noise values stored contiguously in row-major order.
+ *
+ * The value at `(x, y)` lives at `y * getStride() + x`, so walking a row touches consecutive memory and a whole map
+ * is a single allocation. Rows are exposed as plain pointers to `getWidth()` values, which batch kernels (e.g.
+ * `PerlinNoise::sampleRow`) write into directly.
+ */
+class NoiseMap
+{
+  private:
+    unsigned int width;        ///< The amount of columns.
+    unsigned int height;       ///< The amount of rows.
+    std::vector<float> values; ///< The values, row after row.
+
+  public:
+    /**
+     * @brief Constructs an empty NoiseMap.
+     */
+    NoiseMap();
+
+    /**
+     * @brief Constructs a NoiseMap with every value set to the same number.
+     *
+     * @param width The amount of columns.
+     * @param height The amount of rows.
+     * @param value The initial value.
+     */
+    NoiseMap(const unsigned int &width, const unsigned int &height, const float &value = 0.f);
+
+    /**
+     * @brief Destructor for the NoiseMap class.
+     */
+    ~NoiseMap();
+
+    /**
+     * @brief Accesses the value at a position. Not bounds checked.
+     *
+     * @param x The column.
+     * @param y The row.
+     * @return The value.
+     */
+    float &operator()(const unsigned int &x, const unsigned int &y)
+    {
+        return values[y * width + x];
+    }
+
+    /**
+     * @brief Accesses the value at a position. Not bounds checked.
+     *
+     * @param x The column.
+     * @param y The row.
+     * @return The value.
+     */
+    const float &operator()(const unsigned int &x, const unsigned int &y) const
+    {
+        return values[y * width + x];
+    }
+
+    /**
+     * @brief Gets a row of the map.
+     *
+     * @param y The row.
+     * @return A pointer to the `getWidth()` values of the row.
+     */
+    float *getRow(const unsigned int &y)
+    {
+        return values.data() + y * width;
+    }
+
+    /**
+     * @brief Gets a row of the map.
+     *
+     * @param y The row.
+     * @return A pointer to the `getWidth()` values of the row.
+     */
+    const float *getRow(const unsigned int &y) const
+    {
+        return values.data() + y * width;
+    }
+
+    /**
+     * @brief Gets every value of the map, row after row.
+     *
+     * @return A pointer to the `getWidth() * getHeight()` values.
+     */
+    const float *getData() const;
+
+    /**
+     * @brief Gets the amount of columns.
+     *
+     * @return The width of the map.
+     */
+    const unsigned int getWidth() const;
+
+    /**
+     * @brief Gets the amount of rows.
+     *
+     * @return The height of the map.
+     */
+    const unsigned int getHeight() const;
+
+    /**
+     * @brief Gets the distance between the starts of two consecutive rows.
+     *
+     * @return The stride of the map, in values.
+     */
+    const unsigned int getStride() const;
+};
@@ -0,0 +1,149 @@
+/**
+ * @file Profiler.hxx
+ * @brief Declares the Profiler class and the macros to time scoped zones of the frame.
+ */
+
+#pragma once
+
+#include "Engine/Languages.hxx"
+
+/**
+ * @brief The amount of zones each thread keeps. Older zones are overwritten.
+ */
+static constexpr size_t PROFILER_BUFFER_CAPACITY = 16384;
+
+/**
+ * @class Profiler
+ * @brief Records how long scoped zones take on every thread, and exports them as a Chrome trace.
+ *
+ * Zones are timed by the `PROFILE_SCOPE` macro, and each thread writes them to its own ring buffer, so recording
+ * never waits for another thread. Only the last `PROFILER_BUFFER_CAPACITY` zones of each thread are kept. The buffer
+ * of a thread that exits is kept for the export, and handed over to the next thread that starts recording.
+ *
+ * The trace can be opened in `chrome://tracing` or Perfetto.
+ */
+class Profiler
+{
+  public:
+    /**
+     * @class Zone
+     * @brief Times its own lifetime, and records it when destroyed.
+     */
+    class Zone
+    {
+      private:
+        const char *name; ///< The name of the zone.
+        uint64_t start;   ///< When the zone started (in nanoseconds since the profiler started).
+
+      public:
+        /**
+         * @brief Starts a zone.
+         *
+         * @param name The name of the zone. Must outlive the profiler, such as a string literal.
+         */
+        Zone(const char *name);
+
+        Zone(const Zone &) = delete;
+        Zone &operator=(const Zone &) = delete;
+
+        /**
+         * @brief Ends the zone and records it.
+         */
+        ~Zone();
+    };
+
+  private:
+    /**
+     * @struct Event
+     * @brief A recorded zone.
+     */
+    struct Event
+    {
+        const char *name;  ///< The name of the zone.
+        uint64_t start;    ///< When the zone started (in nanoseconds since the profiler started).
+        uint64_t duration; ///< How long the zone took (in nanoseconds).
+        uint32_t thread;   ///< The thread the zone ran on.
+    };
+
+    /**
+     * @struct Buffer
+     * @brief The ring buffer of the zones recorded by a thread.
+     */
+    struct Buffer
+    {
+        std::mutex mutex;          ///< Guards the events. Only contended while exporting.
+        std::vector<Event> events; ///< The recorded zones.
+        uint64_t count;            ///< The amount of zones ever recorded. The next one goes at `count % capacity`.
+    };
+
+    struct Registry;   ///< The buffers of every thread, and the names of the threads.
+    struct ThreadSlot; ///< The buffer the calling thread records to. Hands it back when the thread exits.
+
+    /**
+     * @brief Gets the registry, created on first use.
+     *
+     * @return The registry.
+     */
+    static Registry &getRegistry();
+
+    /**
+     * @brief Gets the slot of the calling thread, numbering the thread on first use.
+     *
+     * @return The slot of the calling thread.
+     */
+    static ThreadSlot &getThreadSlot();
+
+    /**
+     * @brief Gets the time since the profiler started.
+     *
+     * @return The time (in nanoseconds).
+     */
+    static const uint64_t now();
+
+    /**
+     * @brief Records a zone on the buffer of the calling thread.
+     *
+     * @param name The name of the zone.
+     * @param start When the zone started.
+     * @param end When the zone ended.
+     */
+    static void record(const char *name, const uint64_t start, const uint64_t end);
+
+  public:
+    /**
+     * @brief Names the calling thread in the exported traces.
+     *
+     * @param name The name of the thread.
+     */
+    static void setThreadName(const std::string &name);
+
+    /**
+     * @brief Exports the recorded zones of every thread as a Chrome `trace_event` JSON file.
+     *
+     * @param path The path of the file to write.
+     * @return The amount of zones exported.
+     *
+     * @throws std::runtime_error if the file cannot be written.
+     */
+    static const size_t exportTrace(const std::filesystem::path &path);
+};
+
+/**
+ * @brief Helpers to give every zone of a scope its own variable name.
+ */
+#define PROFILER_CONCAT_IMPL(a, b) a##b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_IMPL(a, b)
+
+/**
+ * @brief Profiling macros, compiled out unless `PROFILER` is defined.
+ *
+ * - `PROFILE_SCOPE(name)` times the rest of the enclosing scope as a zone named `name` (a string literal).
+ * - `PROFILE_THREAD(name)` names the calling thread in the exported traces.
+ */
+#ifdef PROFILER
+#define PROFILE_SCOPE(name) Profiler::Zone PROFILER_CONCAT(profilerZone, __COUNTER__)(name)
+#define PROFILE_THREAD(name) Profiler::setThreadName(name)
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_THREAD(name) ((void)0)
+#endif
@@ -0,0 +1,73 @@
+/**
+ * @file ThreadPool.hxx
+ * @brief Declares the ThreadPool class to run tasks on a fixed set of worker threads.
+ */
+
+#pragma once
+
+#include "Tools/Profiler.hxx"
+
+/**
+ * @class ThreadPool
+ * @brief A fixed set of worker threads that run tasks in the order they were enqueued.
+ *
+ * Tasks still in the queue when the pool is destroyed are run before the workers are joined, so work handed to the
+ * pool (e.g. writing a save) is never lost.
+ */
+class ThreadPool
+{
+  private:
+    std::mutex mutex;                        ///< Guards the task queue.
+    std::condition_variable condition;       ///< Wakes the workers up when tasks arrive or the pool stops.
+    std::queue<std::function<void()>> tasks; ///< The pending tasks.
+    bool running;                            ///< Whether the workers should wait for new tasks.
+    std::vector<std::thread> workers;        ///< The worker threads.
+    std::string name;                        ///< The name of the worker threads in the profiler traces.
+
+    /**
+     * @brief The loop run by each worker thread.
+     */
+    void work();
+
+  public:
+    /**
+     * @brief Constructs a ThreadPool and starts its workers.
+     *
+     * @param worker_count The amount of worker threads (at least one is started).
+     * @param name The name of the worker threads in the profiler traces.
+     */
+    ThreadPool(const unsigned int worker_count, const std::string &name = "Worker");
+
+    /**
+     * @brief Runs the pending tasks, then joins the workers.
+     */
+    ~ThreadPool();
+
+    /**
+     * @brief Enqueues a task.
+     *
+     * @param task The task to run.
+     * @return A future that becomes ready when the task is done, holding its result or exception.
+     */
+    template <typename F>
+    std::future<std::invoke_result_t<F>> enqueue(F &&task)
+    {
+        auto packaged = std::make_shared<std::packaged_task<std::invoke_result_t<F>()>>(std::forward<F>(task));
+        std::future<std::invoke_result_t<F>> future = packaged->get_future();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.emplace([packaged]() { (*packaged)(); });
+        }
+
+        condition.notify_one();
+        return future;
+    }
+
+    /**
+     * @brief Gets the amount of worker threads.
+     *
+     * @return The amount of workers.
+     */
+    const size_t getWorkerCount() const;
+};
@@ -147,6 +147,9 @@ void Engine::initVariables()
     dt = 0.f;
     dtClock.restart();
 
+    tickDt = 1.f / std::clamp(gfx.tickRate, MIN_TICK_RATE, MAX_TICK_RATE);
+    tickAccumulator = 0.f;
+
     gridSize = GRID_SIZE; // 16x16 pixels tile textures.
     scale = std::max(1u, static_cast<unsigned int>(std::roundf((vm.size.x + vm.size.y) / 693.f)));
 }
@@ -186,6 +189,8 @@ void Engine::initEngineData()
     engineData.event = std::nullopt;
     engineData.mouseData = std::nullopt;
     engineData.gfx = &gfx;
+    engineData.tickDt = tickDt;
+    engineData.interpolation = 0.f;
 }
 
 void Engine::initMainMenuState()
@@ -195,6 +200,8 @@ void Engine::initMainMenuState()
 
 void Engine::pollWindowEvents()
 {
+    PROFILE_SCOPE("Engine::pollWindowEvents");
+
     engineData.mouseData = std::nullopt;
 
     while (const auto event = window.pollEvent())
@@ -217,12 +224,35 @@ void Engine::pollWindowEvents()
 
 void Engine::updateDeltaTime()
 {
-    dt = dtClock.restart().asSeconds();
-    std::max(dt, .25f); // Prevent lag spikes and spiral of death
+    dt = std::min(dtClock.restart().asSeconds(), MAX_FRAME_TIME); // Prevent lag spikes and spiral of death
+}
+
+void Engine::updateSimulation()
+{
+    PROFILE_SCOPE("Engine::updateSimulation");
+
+    tickAccumulator += dt;
+
+    unsigned int ticks = 0;
+
+    while (tickAccumulator >= tickDt && ticks < MAX_TICKS_PER_FRAME)
+    {
+        states.top()->fixedUpdate(tickDt);
+        tickAccumulator -= tickDt;
+        ++ticks;
+    }
+
+    // Too far behind: drop the backlog instead of catching up over the next frames.
+    if (tickAccumulator >= tickDt)
+        tickAccumulator = std::fmod(tickAccumulator, tickDt);
+
+    engineData.interpolation = tickAccumulator / tickDt;
 }
 
 void Engine::update()
 {
+    PROFILE_SCOPE("Engine::update");
+
     updateDeltaTime();
 
     if (!states.empty())
@@ -246,6 +276,7 @@ void Engine::update()
         }
         else
         {
+            updateSimulation();
             states.top()->update(dt);
         }
     }
@@ -255,12 +286,17 @@ void Engine::update()
 
 void Engine::render()
 {
+    PROFILE_SCOPE("Engine::render");
+
     window.clear();
 
     if (!states.empty())
         states.top()->render(window);
 
-    window.display();
+    {
+        PROFILE_SCOPE("Engine::display");
+        window.display();
+    }
 }
 
 /* CONSTRUCTOR | DESTRUCTOR +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++=+++++++++++++ */
@@ -284,8 +320,12 @@ Engine::~Engine() = default;
 
 void Engine::run()
 {
+    PROFILE_THREAD("Main");
+
     while (window.isOpen())
     {
+        PROFILE_SCOPE("Engine::frame");
+
         pollWindowEvents();
 
         update();
@@ -11,6 +11,8 @@ GraphicsSettings::GraphicsSettings() : logger("GraphicsSettings")
     fontSmoothness = false;
     textureSmoothness = false;
     resourcePack = "Vanilla";
+    tickRate = DEFAULT_TICK_RATE;
+    memoryBudget = DEFAULT_CHUNK_MEMORY_BUDGET;
 }
 
 GraphicsSettings::~GraphicsSettings() = default;
@@ -33,6 +35,13 @@ const bool GraphicsSettings::loadFromFile(const std::filesystem::path path)
         textureSmoothness = obj.at("textureSmoothness").getAs<bool>();
         resourcePack = obj.at("resourcePack").getAs<std::string>();
 
+        // Settings saved before the tick rate and the memory budget existed keep the defaults.
+        if (obj.count("tickRate"))
+            tickRate = obj.at("tickRate").getAs<long long int>();
+
+        if (obj.count("memoryBudget"))
+            memoryBudget = obj.at("memoryBudget").getAs<long long int>();
+
         logger.logInfo(_("Loaded settings from file: ") + path.string());
 
         return true;
@@ -63,6 +72,8 @@ const bool GraphicsSettings::saveToFile(const std::filesystem::path path)
     obj["fontSmoothness"] = fontSmoothness;
     obj["textureSmoothness"] = textureSmoothness;
     obj["resourcePack"] = resourcePack;
+    obj["tickRate"] = tickRate;
+    obj["memoryBudget"] = memoryBudget;
 
     try
     {
@@ -9,7 +9,7 @@ ResourcePack::~ResourcePack()
     deleteCache();
 }
 
-const bool ResourcePack::load(const std::string &filename)
+const bool ResourcePack::loadData(const std::string &filename)
 {
     if (!std::filesystem::exists(CACHE_FOLDER + "ResourcePacks/"))
         std::filesystem::create_directories(CACHE_FOLDER + "ResourcePacks/");
@@ -59,6 +59,56 @@ const bool ResourcePack::load(const std::string &filename)
     tag= pack_obj.at("tag").getAs<std::string>();
     description = pack_obj.at("description").getAs<std::string>();
 
+    /* Tile Database ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ */
+
+    std::ifstream tile_data_file(cacheRootPath / "tile_db.json");
+
+    if (!tile_data_file.is_open())
+        logger.logError(_("Failed to open \"tile_db.json\" file in resource pack: ") + name, false);
+
+    std::stringstream tile_data_stream;
+    tile_data_stream << tile_data_file.rdbuf();
+
+    JArray tile_data_array = JSON::parse(tile_data_stream.str()).getAs<JArray>();
+
+    for (auto &entry : tile_data_array)
+    {
+        try
+        {
+            JObject obj = entry.getAs<JObject>();
+
+            std::string tag, name;
+            int rect_x, rect_y, size;
+
+            tag = obj.at("tag").getAs<std::string>();
+            name = obj.at("name").getAs<std::string>();
+            rect_x = static_cast<int>(obj.at("rectX").getAs<long long>());
+            rect_y = static_cast<int>(obj.at("rectY").getAs<long long>());
+            size = static_cast<int>(obj.at("size").getAs<long long>());
+
+            tileDb.insert(tag, name, rect_x, rect_y, size);
+        }
+        catch (std::runtime_error &e)
+        {
+            logger.logError(_("Error while reading tile database: ") + static_cast<std::string>(e.what()), false);
+            return false;
+        }
+    }
+
+    /* Biome Rules ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ */
+
+    // Optional: packs without rules generate terrain with the built-in ones.
+    if (std::filesystem::exists(cacheRootPath / BIOME_RULES_FILENAME))
+        biomeRules.load(cacheRootPath / BIOME_RULES_FILENAME);
+
+    return true;
+}
+
+const bool ResourcePack::load(const std::string &filename)
+{
+    if (!loadData(filename))
+        return false;
+
     /* Icon +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ */
 
     if (!this->icon.loadFromFile(cacheRootPath / "icon.png"))
@@ -153,42 +203,6 @@ const bool ResourcePack::load(const std::string &filename)
             musics[key] = std::make_shared<sf::Music>(cacheRootPath / path);
     }
 
-    /* Tile Database ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ */
-
-    std::ifstream tile_data_file(cacheRootPath / "tile_db.json");
-
-    if (!tile_data_file.is_open())
-        logger.logError(_("Failed to open \"tile_db.json\" file in resource pack: ") + name, false);
-
-    std::stringstream tile_data_stream;
-    tile_data_stream << tile_data_file.rdbuf();
-
-    JArray tile_data_array = JSON::parse(tile_data_stream.str()).getAs<JArray>();
-
-    for (auto &entry : tile_data_array)
-    {
-        try
-        {
-            JObject obj = entry.getAs<JObject>();
-
-            std::string tag, name;
-            int rect_x, rect_y, size;
-
-            tag = obj.at("tag").getAs<std::string>();
-            name = obj.at("name").getAs<std::string>();
-            rect_x = static_cast<int>(obj.at("rectX").getAs<long long>());
-            rect_y = static_cast<int>(obj.at("rectY").getAs<long long>());
-            size = static_cast<int>(obj.at("size").getAs<long long>());
-
-            tileDb.insert(tag, name, rect_x, rect_y, size);
-        }
-        catch (std::runtime_error &e)
-        {
-            logger.logError(_("Error while reading tile database: ") + static_cast<std::string>(e.what()), false);
-            return false;
-        }
-    }
-
     logger.logInfo(_("Sucessfully loaded resource pack ") + name + ": " + std::to_string(textures.size()) +
                    _(" textures, ") + std::to_string(fonts.size()) + _(" fonts, ") +
                    std::to_string(soundBuffers.size()) + _(" sound buffers, ") + std::to_string(globalSounds.size()) +
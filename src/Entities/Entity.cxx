@@ -40,10 +40,49 @@ Entity::Entity(const std::string &name, const std::uint8_t &type, const sf::Vect
     baseSprite->setPosition(
         sf::Vector2f(spawnGridPosition * static_cast<float>(GRID_SIZE) * scale) +
         sf::Vector2f(baseSprite->getGlobalBounds().size.x / 2.f, baseSprite->getGlobalBounds().size.y / 2.f));
+    previousPosition = baseSprite->getPosition();
 }
 
 Entity::~Entity() = default;
 
+void Entity::renderInterpolated(sf::RenderTarget &target, const bool &show_hitboxes, const float &interpolation)
+{
+    const sf::Vector2f offset = getInterpolatedPosition(interpolation) - getPosition();
+
+    if (offset == sf::Vector2f())
+    {
+        render(target, show_hitboxes);
+        return;
+    }
+
+    // Draw the sprites at the interpolated position, then put them back where the simulation left them.
+    std::vector<sf::Vector2f> positions;
+    positions.reserve(layers.size());
+
+    for (auto &[_, sprite] : layers)
+    {
+        if (sprite)
+        {
+            positions.push_back(sprite->getPosition());
+            sprite->move(offset);
+        }
+    }
+
+    render(target, show_hitboxes);
+
+    auto position = positions.begin();
+    for (auto &[_, sprite] : layers)
+    {
+        if (sprite)
+            sprite->setPosition(*position++);
+    }
+}
+
+void Entity::storePreviousPosition()
+{
+    previousPosition = getPosition();
+}
+
 void Entity::move(const float &dt, const MovementDirection &direction)
 {
     if (movementFunctionality.has_value())
@@ -92,6 +131,13 @@ const sf::Vector2f Entity::getPosition() const
     return baseSprite->getPosition();
 }
 
+const sf::Vector2f Entity::getInterpolatedPosition(const float &interpolation) const
+{
+    const sf::Vector2f position = previousPosition + (getPosition() - previousPosition) * interpolation;
+
+    return sf::Vector2f(std::round(position.x), std::round(position.y));
+}
+
 const sf::Vector2f Entity::getSize() const
 {
     return baseSprite->getGlobalBounds().size;
@@ -231,6 +277,8 @@ void Entity::setGridPosition(const sf::Vector2f &grid_position)
     for (auto &[_, sprite] : layers)
         if (sprite)
             sprite->move(offset);
+
+    previousPosition = baseSprite->getPosition();
 }
 
 void Entity::setCenterGridPosition(const sf::Vector2f &grid_position)
@@ -242,6 +290,8 @@ void Entity::setCenterGridPosition(const sf::Vector2f &grid_position)
     for (auto &[_, sprite] : layers)
         if (sprite)
             sprite->move(offset);
+
+    previousPosition = baseSprite->getPosition();
 }
 
 void Entity::setHitBoxPosition(const sf::Vector2f &position)
@@ -24,26 +24,26 @@ void MovementFunctionality::move(const float &dt, const uint8_t direction)
     {
         this->direction = direction;
         state = MovementState::Walking;
-        velocity.y = std::round(-maxVelocity * scale * dt);
+        velocity.y = -maxVelocity * scale * dt;
     }
     else if (direction == MovementDirection::Down && flags & MovementAllow::AllowDown)
     {
         this->direction = direction;
         state = MovementState::Walking;
-        velocity.y = std::round(maxVelocity * scale * dt);
+        velocity.y = maxVelocity * scale * dt;
     }
     else if (direction == MovementDirection::Left && flags & MovementAllow::AllowLeft)
     {
         this->direction = direction;
         state = MovementState::Walking;
-        velocity.x = std::round(-maxVelocity * scale * dt);
+        velocity.x = -maxVelocity * scale * dt;
     }
     else if (direction == MovementDirection::Right && flags & MovementAllow::AllowRight)
     {
         this->direction = direction;
         state = MovementState::Walking;
 
-        velocity.x = std::round(maxVelocity * scale * dt);
+        velocity.x = maxVelocity * scale * dt;
     }
 
     for (auto &[_, sprite] : layers)
@@ -0,0 +1,110 @@
+#include "Map/BiomeRules.hxx"
+#include "stdafx.hxx"
+
+/* PRIVATE METHODS ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ */
+
+void BiomeRules::setDefaults()
+{
+    const std::vector<DecorationRule> grass_decorations = {
+        {"pixelminer:arbust_2", .001f, 1},
+        {"pixelminer:arbust_1", .001f, 1},
+        {"pixelminer:short_grass", .003f, 1},
+    };
+
+    rules.fill(BiomeRule());
+
+    rules[BiomeType::Desert].baseTileTag = "pixelminer:sand_tile";
+    rules[BiomeType::Forest] = {"pixelminer:grass_tile", grass_decorations};
+    rules[BiomeType::Grassland] = {"pixelminer:grass_tile", grass_decorations};
+    rules[BiomeType::Jungle] = {"pixelminer:grass_tile", grass_decorations};
+    rules[BiomeType::Mountains].baseTileTag = "pixelminer:stone_tile";
+    rules[BiomeType::Ocean].baseTileTag = "pixelminer:water_tile";
+    rules[BiomeType::Tundra] = {"pixelminer:snowy_grass_tile", {{"pixelminer:snow_tile", .01f, 1}}};
+}
+
+const BiomeType BiomeRules::getTypeByKey(const std::string &key)
+{
+    if (key == "desert")
+        return BiomeType::Desert;
+    if (key == "forest")
+        return BiomeType::Forest;
+    if (key == "grassland")
+        return BiomeType::Grassland;
+    if (key == "jungle")
+        return BiomeType::Jungle;
+    if (key == "mountains")
+        return BiomeType::Mountains;
+    if (key == "ocean")
+        return BiomeType::Ocean;
+    if (key == "tundra")
+        return BiomeType::Tundra;
+
+    return BiomeType::UnknownBiome;
+}
+
+/* CONSTRUCTOR AND DESTRUCTOR +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ */
+
+BiomeRules::BiomeRules() : logger("BiomeRules")
+{
+    setDefaults();
+}
+
+BiomeRules::~BiomeRules() = default;
+
+/* PUBLIC METHODS +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ */
+
+const bool BiomeRules::load(const std::filesystem::path &path)
+{
+    std::array<BiomeRule, BIOME_TYPE_COUNT> loaded_rules = rules;
+
+    try
+    {
+        for (auto &entry : JSON::parse(path).getAs<JArray>())
+        {
+            JObject obj = entry.getAs<JObject>();
+
+            const std::string key = obj.at("biome").getAs<std::string>();
+            const BiomeType type = getTypeByKey(key);
+
+            if (type == BiomeType::UnknownBiome)
+            {
+                logger.logWarning(_("Unknown biome in biome rules: ") + key);
+                continue;
+            }
+
+            BiomeRule rule;
+            rule.baseTileTag = obj.at("baseTile").getAs<std::string>();
+
+            for (auto &decoration : obj.at("decorations").getAs<JArray>())
+            {
+                JObject decoration_obj = decoration.getAs<JObject>();
+                JValue probability = decoration_obj.at("probability");
+
+                rule.decorations.push_back({
+                    decoration_obj.at("tile").getAs<std::string>(),
+                    static_cast<float>(probability.isIntegerNumber() ? probability.getAs<long long>()
+                                                                     : probability.getAs<double>()),
+                    static_cast<uint8_t>(decoration_obj.at("z").getAs<long long>()),
+                });
+            }
+
+            loaded_rules[type] = std::move(rule);
+        }
+    }
+    catch (std::exception &e)
+    {
+        logger.logError(_("Failed to read biome rules: ") + path.string() + " (" + e.what() + ")", false);
+        return false;
+    }
+
+    rules = std::move(loaded_rules);
+    return true;
+}
+
+const BiomeRule &BiomeRules::get(const BiomeId &biome_id) const
+{
+    if (biome_id >= rules.size())
+        return rules[BiomeType::UnknownBiome];
+
+    return rules[biome_id];
+}
@@ -5,20 +5,106 @@ void Chunk::draw(sf::RenderTarget &target, sf::RenderStates states) const
 {
     states.transform *= getTransform();
     states.texture = &texturePack;
-    target.draw(vertices, states);
+    target.draw(mesh, states);
 }
 
-Chunk::Chunk(sf::Texture &texture_pack, const sf::Vector2u chunk_index, const float &scale, uint8_t flags)
-    : texturePack(texture_pack), chunkIndex(chunk_index), scale(scale), flags(flags)
+const uint16_t Chunk::acquirePaletteIndex(const TileData &data)
 {
-    vertices.setPrimitiveType(sf::PrimitiveType::Triangles);
+    uint16_t free_index = EMPTY_CELL;
 
-    vertices.resize(CHUNK_SIZE_IN_TILES.x * CHUNK_SIZE_IN_TILES.y * CHUNK_SIZE_IN_TILES.z * QUAD_VERTEX_COUNT);
+    for (uint16_t i = 0; i < palette.size(); i++)
+    {
+        if (palette[i] == &data)
+        {
+            paletteRefs[i]++;
+            return i;
+        }
+
+        if (!palette[i] && free_index == EMPTY_CELL)
+            free_index = i;
+    }
+
+    if (free_index == EMPTY_CELL)
+    {
+        free_index = static_cast<uint16_t>(palette.size());
+        palette.push_back(nullptr);
+        paletteRefs.push_back(0);
+    }
+
+    palette[free_index] = &data;
+    paletteRefs[free_index] = 1;
+
+    return free_index;
+}
+
+void Chunk::releasePaletteIndex(const uint16_t index)
+{
+    if (--paletteRefs[index] == 0)
+        palette[index] = nullptr;
+}
+
+void Chunk::markDirty(const unsigned int index)
+{
+    if (!dirtyCells.test(index))
+    {
+        dirtyCells.set(index);
+        dirtyList.push_back(static_cast<uint16_t>(index));
+    }
+}
+
+std::atomic<uint64_t> Chunk::nextMeshVersion(1);
+
+void Chunk::patchMesh(ChunkMesh &target, const sf::Vector2i &chunk_index, const float scale,
+                      const std::vector<const TileData *> &palette, const TileCells &cells,
+                      const std::array<sf::Color, CHUNK_AREA> &tints, const std::vector<uint16_t> &dirty_list)
+{
+    if (dirty_list.empty())
+        return;
+
+    const int GRID_START_X = chunk_index.x * static_cast<int>(CHUNK_SIZE_IN_TILES.x);
+    const int GRID_START_Y = chunk_index.y * static_cast<int>(CHUNK_SIZE_IN_TILES.y);
+
+    auto set_quad = [&](const unsigned int index) {
+        const unsigned int x = index % CHUNK_SIZE_IN_TILES.x;
+        const unsigned int y = (index / CHUNK_SIZE_IN_TILES.x) % CHUNK_SIZE_IN_TILES.y;
+
+        target.setQuad(index, sf::Vector2i(GRID_START_X + static_cast<int>(x), GRID_START_Y + static_cast<int>(y)),
+                       scale, palette[cells[index]]->rect, tints[y * CHUNK_SIZE_IN_TILES.x + x]);
+    };
+
+    if (dirty_list.size() > CHUNK_VOLUME / 4)
+    {
+        target.clear();
+
+        // Cells are laid out layer by layer, so the slots of each layer are allocated in grid order.
+        for (unsigned int i = 0; i < CHUNK_VOLUME; i++)
+            if (cells[i] != EMPTY_CELL)
+                set_quad(i);
+    }
+    else
+    {
+        for (const uint16_t index : dirty_list)
+        {
+            if (cells[index] == EMPTY_CELL)
+                target.removeQuad(index);
+            else
+                set_quad(index);
+        }
+    }
+}
+
+Chunk::Chunk(sf::Texture &texture_pack, const sf::Vector2i chunk_index, const float &scale, uint8_t flags)
+    : texturePack(texture_pack), meshVersion(0), batchDepth(0), epoch(0), savedEpoch(0), status(ChunkStatus::Empty),
+      chunkIndex(chunk_index), scale(scale), flags(flags)
+{
+    cells.fill(EMPTY_CELL);
+    tints.fill(sf::Color::White);
 
     chunkBorders.setSize(
         sf::Vector2f(CHUNK_SIZE_IN_TILES.x * GRID_SIZE * scale, CHUNK_SIZE_IN_TILES.y * GRID_SIZE * scale));
-    chunkBorders.setPosition(sf::Vector2f(chunk_index.x * CHUNK_SIZE_IN_TILES.x * GRID_SIZE * scale,
-                                          chunk_index.y * CHUNK_SIZE_IN_TILES.y * GRID_SIZE * scale));
+    chunkBorders.setPosition(
+        sf::Vector2f(static_cast<float>(chunk_index.x) * CHUNK_SIZE_IN_TILES.x * GRID_SIZE * scale,
+                     static_cast<float>(chunk_index.y) * CHUNK_SIZE_IN_TILES.y * GRID_SIZE * scale));
     chunkBorders.setFillColor(sf::Color::Transparent);
     chunkBorders.setOutlineThickness(-1.f);
     chunkBorders.setOutlineColor(sf::Color::Green);
@@ -27,28 +113,256 @@ Chunk::Chunk(sf::Texture &texture_pack, const sf::Vector2u chunk_index, const fl
 Chunk::~Chunk() = default;
 
 void Chunk::update(const float &dt)
+{}
+
+void Chunk::updateMesh()
+{
+    // The cells taken by a build still in flight are patched here, as that build will not be swapped in anymore.
+    for (const uint16_t index : buildingList)
+        markDirty(index);
+
+    buildingList.clear();
+
+    if (dirtyList.empty())
+        return;
+
+    patchMesh(mesh, chunkIndex, scale, palette, cells, tints, dirtyList);
+
+    dirtyCells.reset();
+    dirtyList.clear();
+    meshVersion = nextMeshVersion++;
+}
+
+std::optional<ChunkMeshSnapshot> Chunk::takeMeshSnapshot()
+{
+    if (dirtyList.empty())
+        return std::nullopt;
+
+    // The cells of a previous build that was not swapped in yet are built again, on top of the drawn mesh.
+    for (const uint16_t index : buildingList)
+        markDirty(index);
+
+    ChunkMeshSnapshot snapshot{chunkIndex, scale, palette, cells, tints, dirtyList, &mesh, nextMeshVersion++};
+
+    meshVersion = snapshot.meshVersion;
+
+    buildingList = std::move(dirtyList);
+    dirtyList.clear();
+    dirtyCells.reset();
+
+    return snapshot;
+}
+
+ChunkMesh Chunk::buildMesh(const ChunkMeshSnapshot &snapshot)
+{
+    // A full rebuild doesn't need the previous quads, so nothing is copied for it.
+    ChunkMesh built = snapshot.dirtyList.size() > CHUNK_VOLUME / 4 ? ChunkMesh() : *snapshot.base;
+
+    patchMesh(built, snapshot.chunkIndex, snapshot.scale, snapshot.palette, snapshot.cells, snapshot.tints,
+              snapshot.dirtyList);
+
+    return built;
+}
+
+const bool Chunk::swapMesh(ChunkMesh &&built, const uint64_t mesh_version)
+{
+    if (mesh_version != meshVersion)
+        return false;
+
+    mesh = std::move(built);
+    buildingList.clear();
+
+    return true;
+}
+
+void Chunk::beginBatch()
+{
+    batchDepth++;
+}
+
+void Chunk::endBatch()
+{
+    if (batchDepth > 0 && --batchDepth == 0)
+        updateMesh();
+}
+
+const bool Chunk::isDirty() const
+{
+    return !dirtyList.empty() || !buildingList.empty();
+}
+
+const size_t Chunk::getVertexCount() const
+{
+    return mesh.getVertexCount();
+}
+
+const size_t Chunk::getMemoryUsage() const
+{
+    return sizeof(Chunk) + palette.capacity() * sizeof(const TileData *) + paletteRefs.capacity() * sizeof(uint16_t) +
+           (dirtyList.capacity() + buildingList.capacity()) * sizeof(uint16_t) + mesh.getMemoryUsage();
+}
+
+const uint64_t Chunk::getEpoch() const
+{
+    return epoch;
+}
+
+const bool Chunk::hasUnsavedChanges() const
+{
+    return epoch != savedEpoch;
+}
+
+void Chunk::markSaved(const uint64_t epoch)
+{
+    savedEpoch = epoch;
+}
+
+const ChunkStatus Chunk::getStatus() const
+{
+    return status;
+}
+
+void Chunk::setStatus(const ChunkStatus status)
+{
+    this->status = status;
+}
+
+const bool Chunk::putTile(const TileData &data, const unsigned int x, const unsigned int y, const unsigned int z)
+{
+    uint16_t &cell = cells[cellIndex(x, y, z)];
+
+    if (cell != EMPTY_CELL)
+        return false;
+
+    cell = acquirePaletteIndex(data);
+    epoch++;
+    markDirty(cellIndex(x, y, z));
+    return true;
+}
+
+const bool Chunk::removeTile(const unsigned int x, const unsigned int y, const unsigned int z)
+{
+    uint16_t &cell = cells[cellIndex(x, y, z)];
+
+    if (cell == EMPTY_CELL)
+        return false;
+
+    releasePaletteIndex(cell);
+    cell = EMPTY_CELL;
+    epoch++;
+    markDirty(cellIndex(x, y, z));
+    return true;
+}
+
+const TileData *Chunk::getTileData(const unsigned int x, const unsigned int y, const unsigned int z) const
 {
-    updateVertexArray();
+    const uint16_t cell = cells[cellIndex(x, y, z)];
+
+    if (cell == EMPTY_CELL)
+        return nullptr;
+
+    return palette[cell];
 }
 
-void Chunk::updateVertexArray()
+std::optional<Tile> Chunk::getTile(const unsigned int x, const unsigned int y, const unsigned int z) const
 {
-    vertices.clear();
+    const TileData *data = getTileData(x, y, z);
 
-    for (auto &x : tiles)
+    if (!data)
+        return std::nullopt;
+
+    return Tile(*data,
+                sf::Vector2i(chunkIndex.x * static_cast<int>(CHUNK_SIZE_IN_TILES.x) + static_cast<int>(x),
+                             chunkIndex.y * static_cast<int>(CHUNK_SIZE_IN_TILES.y) + static_cast<int>(y)),
+                z, scale, getTint(x, y));
+}
+
+const int Chunk::getTopLayer(const unsigned int x, const unsigned int y) const
+{
+    for (int z = CHUNK_SIZE_IN_TILES.z - 1; z >= 0; z--)
     {
-        for (auto &y : x)
-        {
-            for (auto &z : y)
-            {
-                if (z)
-                {
-                    sf::VertexArray tile_vertices = z->getVertexArray();
-
-                    for (int i = 0; i < QUAD_VERTEX_COUNT; i++)
-                        vertices.append(tile_vertices[i]);
-                }
-            }
-        }
+        if (cells[cellIndex(x, y, z)] != EMPTY_CELL)
+            return z;
+    }
+
+    return -1;
+}
+
+const unsigned int Chunk::getTileCount() const
+{
+    unsigned int count = 0;
+    for (auto &refs : paletteRefs)
+        count += refs;
+
+    return count;
+}
+
+const std::vector<const TileData *> &Chunk::getPalette() const
+{
+    return palette;
+}
+
+const TileCells &Chunk::getCells() const
+{
+    return cells;
+}
+
+ChunkSaveSnapshot Chunk::takeSaveSnapshot() const
+{
+    return {chunkIndex, flags, palette, cells};
+}
+
+void Chunk::assign(const std::vector<const TileData *> &palette, const TileCells &cells)
+{
+    beginBatch();
+    epoch++;
+
+    this->palette = palette;
+    paletteRefs.assign(palette.size(), 0);
+
+    for (unsigned int i = 0; i < CHUNK_VOLUME; i++)
+    {
+        uint16_t cell = cells[i];
+
+        if (cell != EMPTY_CELL && (cell >= palette.size() || !palette[cell]))
+            cell = EMPTY_CELL;
+
+        if (cell != EMPTY_CELL)
+            paletteRefs[cell]++;
+
+        if (this->cells[i] != EMPTY_CELL || cell != EMPTY_CELL)
+            markDirty(i);
+
+        this->cells[i] = cell;
+    }
+
+    // Drop the entries that no cell uses, so they can be reused.
+    for (size_t i = 0; i < this->palette.size(); i++)
+    {
+        if (paletteRefs[i] == 0)
+            this->palette[i] = nullptr;
+    }
+
+    endBatch();
+}
+
+const sf::Color &Chunk::getTint(const unsigned int x, const unsigned int y) const
+{
+    return tints[y * CHUNK_SIZE_IN_TILES.x + x];
+}
+
+void Chunk::setTint(const unsigned int x, const unsigned int y, const sf::Color &color)
+{
+    sf::Color &tint = tints[y * CHUNK_SIZE_IN_TILES.x + x];
+
+    if (tint == color)
+        return;
+
+    tint = color;
+
+    for (unsigned int z = 0; z < CHUNK_SIZE_IN_TILES.z; z++)
+    {
+        if (cells[cellIndex(x, y, z)] != EMPTY_CELL)
+            markDirty(cellIndex(x, y, z));
     }
 }
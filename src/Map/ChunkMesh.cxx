@@ -0,0 +1,94 @@
+#include "Map/ChunkMesh.hxx"
+#include "stdafx.hxx"
+
+void ChunkMesh::draw(sf::RenderTarget &target, sf::RenderStates states) const
+{
+    for (auto &layer : layers)
+    {
+        if (layer.getVertexCount() > 0)
+            target.draw(layer, states);
+    }
+}
+
+ChunkMesh::ChunkMesh()
+{
+    for (auto &layer : layers)
+        layer.setPrimitiveType(sf::PrimitiveType::Triangles);
+
+    slots.fill(EMPTY_CELL);
+}
+
+ChunkMesh::~ChunkMesh() = default;
+
+void ChunkMesh::clear()
+{
+    for (auto &layer : layers)
+        layer.clear();
+
+    for (auto &owners : slotOwners)
+        owners.clear();
+
+    slots.fill(EMPTY_CELL);
+}
+
+void ChunkMesh::setQuad(const unsigned int cell_index, const sf::Vector2i &grid_position, const float &scale,
+                        const sf::IntRect &texture_rect, const sf::Color &color)
+{
+    const unsigned int z = cell_index / CHUNK_AREA;
+    sf::VertexArray &layer = layers[z];
+
+    if (slots[cell_index] == EMPTY_CELL)
+    {
+        slots[cell_index] = static_cast<uint16_t>(slotOwners[z].size());
+        slotOwners[z].push_back(static_cast<uint16_t>(cell_index));
+        layer.resize(layer.getVertexCount() + QUAD_VERTEX_COUNT);
+    }
+
+    TileBase::writeQuad(&layer[slots[cell_index] * QUAD_VERTEX_COUNT], grid_position, scale, texture_rect, color);
+}
+
+void ChunkMesh::removeQuad(const unsigned int cell_index)
+{
+    const uint16_t slot = slots[cell_index];
+
+    if (slot == EMPTY_CELL)
+        return;
+
+    const unsigned int z = cell_index / CHUNK_AREA;
+    sf::VertexArray &layer = layers[z];
+    std::vector<uint16_t> &owners = slotOwners[z];
+
+    const uint16_t last_slot = static_cast<uint16_t>(owners.size() - 1);
+
+    // Fill the hole with the last quad of the layer, so the vertex array stays dense.
+    if (slot != last_slot)
+    {
+        for (int i = 0; i < QUAD_VERTEX_COUNT; i++)
+            layer[slot * QUAD_VERTEX_COUNT + i] = layer[last_slot * QUAD_VERTEX_COUNT + i];
+
+        owners[slot] = owners[last_slot];
+        slots[owners[slot]] = slot;
+    }
+
+    owners.pop_back();
+    layer.resize(layer.getVertexCount() - QUAD_VERTEX_COUNT);
+    slots[cell_index] = EMPTY_CELL;
+}
+
+const size_t ChunkMesh::getVertexCount() const
+{
+    size_t count = 0;
+    for (auto &layer : layers)
+        count += layer.getVertexCount();
+
+    return count;
+}
+
+const size_t ChunkMesh::getMemoryUsage() const
+{
+    size_t bytes = getVertexCount() * sizeof(sf::Vertex);
+    for (auto &owners : slotOwners)
+        bytes += owners.capacity() * sizeof(uint16_t);
+
+    return bytes;
+}
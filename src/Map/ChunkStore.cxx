@@ -0,0 +1,311 @@
+#include "Map/ChunkStore.hxx"
+#include "stdafx.hxx"
+
+/* PRIVATE METHODS ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ */
+
+const uint64_t ChunkStore::getKey(const sf::Vector2i &region_index)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(region_index.x)) << 32) |
+           static_cast<uint32_t>(region_index.y);
+}
+
+const unsigned int ChunkStore::getSlot(const sf::Vector2i &chunk_index)
+{
+    const int REGION_WIDTH = static_cast<int>(REGION_SIZE_IN_CHUNKS.x);
+    const int REGION_HEIGHT = static_cast<int>(REGION_SIZE_IN_CHUNKS.y);
+
+    // Positive remainders, so negative chunk indexes land in the same slots as positive ones.
+    const int x = ((chunk_index.x % REGION_WIDTH) + REGION_WIDTH) % REGION_WIDTH;
+    const int y = ((chunk_index.y % REGION_HEIGHT) + REGION_HEIGHT) % REGION_HEIGHT;
+
+    return static_cast<unsigned int>(y * REGION_WIDTH + x);
+}
+
+ChunkStore::RegionPage *ChunkStore::findPage(const sf::Vector2i &region_index) const
+{
+    const PageTable *pages = table.load();
+
+    auto it = pages->find(getKey(region_index));
+    return it != pages->end() ? it->second : nullptr;
+}
+
+ChunkStore::RegionPage &ChunkStore::acquirePage(const sf::Vector2i &region_index)
+{
+    const PageTable *pages = table.load();
+
+    auto it = pages->find(getKey(region_index));
+    if (it != pages->end())
+        return *it->second;
+
+    // Readers may be walking the current table, so the new page goes into a copy that replaces it.
+    RegionPage *page = new RegionPage();
+
+    PageTable *next = new PageTable(*pages);
+    next->emplace(getKey(region_index), page);
+
+    table.store(next);
+    reclaimer.retire(pages);
+
+    return *page;
+}
+
+void ChunkStore::releasePageIfUnused(const sf::Vector2i &region_index)
+{
+    const PageTable *pages = table.load();
+
+    auto it = pages->find(getKey(region_index));
+    if (it == pages->end() || it->second->chunkCount > 0 || it->second->loaded.load())
+        return;
+
+    RegionPage *page = it->second;
+
+    PageTable *next = new PageTable(*pages);
+    next->erase(getKey(region_index));
+
+    table.store(next);
+    reclaimer.retire(pages);
+    reclaimer.retire(page);
+}
+
+void ChunkStore::measure(RegionPage &page, const unsigned int slot)
+{
+    Chunk *chunk = page.chunks[slot].load();
+    const size_t bytes = chunk ? chunk->getMemoryUsage() : 0;
+
+    page.bytes = page.bytes - page.chunkBytes[slot] + bytes;
+    memoryUsage += bytes;
+    memoryUsage -= page.chunkBytes[slot];
+    page.chunkBytes[slot] = bytes;
+}
+
+/* CONSTRUCTOR AND DESTRUCTOR +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ */
+
+ChunkStore::ChunkStore()
+    : table(new PageTable()), lastRevision(0), chunkCount(0), memoryUsage(0), clock(0), hits(0), misses(0),
+      evictions(0)
+{}
+
+ChunkStore::~ChunkStore()
+{
+    const PageTable *pages = table.load();
+
+    for (const auto &[key, page] : *pages)
+    {
+        for (auto &slot : page->chunks)
+            delete slot.load();
+
+        delete page;
+    }
+
+    delete pages;
+}
+
+/* PUBLIC METHODS +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ */
+
+const sf::Vector2i ChunkStore::getRegionIndex(const sf::Vector2i &chunk_index)
+{
+    const int REGION_WIDTH = static_cast<int>(REGION_SIZE_IN_CHUNKS.x);
+    const int REGION_HEIGHT = static_cast<int>(REGION_SIZE_IN_CHUNKS.y);
+
+    // Integer division rounds towards zero, which would fold the regions at -1 and 0 together.
+    return sf::Vector2i(chunk_index.x >= 0 ? chunk_index.x / REGION_WIDTH : (chunk_index.x + 1) / REGION_WIDTH - 1,
+                        chunk_index.y >= 0 ? chunk_index.y / REGION_HEIGHT : (chunk_index.y + 1) / REGION_HEIGHT - 1);
+}
+
+ChunkStore::ReadGuard ChunkStore::read() const
+{
+    return reclaimer.pin();
+}
+
+Chunk *ChunkStore::get(const sf::Vector2i &chunk_index) const
+{
+    const ReadGuard guard = read();
+
+    RegionPage *page = findPage(getRegionIndex(chunk_index));
+    Chunk *chunk = page ? page->chunks[getSlot(chunk_index)].load() : nullptr;
+
+    // Relaxed: the counters and stamps are only statistics, they don't order anything.
+    if (chunk)
+    {
+        hits.fetch_add(1, std::memory_order_relaxed);
+        page->lastAccess.store(clock.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    else
+        misses.fetch_add(1, std::memory_order_relaxed);
+
+    return chunk;
+}
+
+const bool ChunkStore::insert(const sf::Vector2i &chunk_index, std::unique_ptr<Chunk> chunk)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    RegionPage &page = acquirePage(getRegionIndex(chunk_index));
+    const unsigned int slot = getSlot(chunk_index);
+
+    if (page.chunks[slot].load())
+        return false;
+
+    page.chunks[slot].store(chunk.release());
+    page.revisions[slot] = ++lastRevision;
+    page.chunkCount++;
+    chunkCount++;
+
+    measure(page, slot);
+    return true;
+}
+
+std::unique_ptr<Chunk> ChunkStore::clone(const sf::Vector2i &chunk_index, uint64_t &revision) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    RegionPage *page = findPage(getRegionIndex(chunk_index));
+    const unsigned int slot = getSlot(chunk_index);
+
+    Chunk *chunk = page ? page->chunks[slot].load() : nullptr;
+    if (!chunk)
+        return nullptr;
+
+    revision = page->revisions[slot];
+    return std::make_unique<Chunk>(*chunk);
+}
+
+const bool ChunkStore::replace(const sf::Vector2i &chunk_index, std::unique_ptr<Chunk> chunk, const uint64_t revision)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    RegionPage *page = findPage(getRegionIndex(chunk_index));
+    const unsigned int slot = getSlot(chunk_index);
+
+    if (!page || !page->chunks[slot].load() || page->revisions[slot] != revision)
+        return false;
+
+    reclaimer.retire(page->chunks[slot].exchange(chunk.release()));
+    page->revisions[slot] = ++lastRevision;
+
+    measure(*page, slot);
+    return true;
+}
+
+void ChunkStore::erase(const sf::Vector2i &chunk_index)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    const sf::Vector2i region_index = getRegionIndex(chunk_index);
+    RegionPage *page = findPage(region_index);
+
+    const unsigned int slot = getSlot(chunk_index);
+
+    if (!page || !page->chunks[slot].load())
+        return;
+
+    reclaimer.retire(page->chunks[slot].exchange(nullptr));
+    page->revisions[slot] = ++lastRevision;
+    measure(*page, slot);
+    page->chunkCount--;
+    chunkCount--;
+
+    releasePageIfUnused(region_index);
+}
+
+const bool ChunkStore::isRegionLoaded(const sf::Vector2i &region_index) const
+{
+    const ReadGuard guard = read();
+
+    RegionPage *page = findPage(region_index);
+    return page && page->loaded.load();
+}
+
+const bool ChunkStore::isRegionComplete(const sf::Vector2i &region_index) const
+{
+    const ReadGuard guard = read();
+
+    RegionPage *page = findPage(region_index);
+    return page && page->loaded.load() && page->complete.load();
+}
+
+void ChunkStore::setRegionStatus(const sf::Vector2i &region_index, const bool loaded, const bool complete)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    RegionPage &page = acquirePage(region_index);
+    page.complete.store(loaded && complete);
+    page.loaded.store(loaded);
+
+    if (loaded)
+    {
+        page.lastAccess.store(clock.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+        for (unsigned int slot = 0; slot < REGION_CHUNK_COUNT; slot++)
+            measure(page, slot);
+    }
+
+    releasePageIfUnused(region_index);
+}
+
+std::vector<sf::Vector2i> ChunkStore::getLoadedRegions() const
+{
+    const ReadGuard guard = read();
+
+    std::vector<sf::Vector2i> regions;
+
+    for (const auto &[key, page] : *table.load())
+    {
+        if (page->loaded.load())
+            regions.emplace_back(static_cast<int32_t>(key >> 32), static_cast<int32_t>(key & 0xFFFFFFFF));
+    }
+
+    return regions;
+}
+
+std::vector<ResidentRegion> ChunkStore::getLeastRecentlyUsedRegions() const
+{
+    std::vector<ResidentRegion> regions;
+
+    {
+        // The memory of the pages is only kept up to date by the writers.
+        std::lock_guard<std::mutex> lock(mutex);
+
+        for (const auto &[key, page] : *table.load())
+        {
+            if (!page->loaded.load())
+                continue;
+
+            const sf::Vector2i region_index(static_cast<int32_t>(key >> 32), static_cast<int32_t>(key & 0xFFFFFFFF));
+            regions.push_back({region_index, page->lastAccess.load(std::memory_order_relaxed), page->bytes});
+        }
+    }
+
+    std::sort(regions.begin(), regions.end(), [](const ResidentRegion &a, const ResidentRegion &b) {
+        return a.lastAccess < b.lastAccess;
+    });
+
+    return regions;
+}
+
+const size_t ChunkStore::getChunkCount() const
+{
+    return chunkCount.load();
+}
+
+const size_t ChunkStore::getMemoryUsage() const
+{
+    return memoryUsage.load();
+}
+
+void ChunkStore::tick()
+{
+    clock.fetch_add(1, std::memory_order_relaxed);
+    reclaimer.reclaim();
+}
+
+void ChunkStore::recordEviction()
+{
+    evictions.fetch_add(1, std::memory_order_relaxed);
+}
+
+const ChunkCacheStats ChunkStore::getStats() const
+{
+    return {chunkCount.load(), memoryUsage.load(), hits.load(std::memory_order_relaxed),
+            misses.load(std::memory_order_relaxed), evictions.load(std::memory_order_relaxed)};
+}
@@ -1,15 +1,6 @@
 #include "Map/Map.hxx"
 #include "stdafx.hxx"
 
-void Map::initRegionStatusArray()
-{
-    for (auto &row : loadedRegions)
-    {
-        for (auto &region : row)
-            region = false;
-    }
-}
-
 void Map::initMetadata(const std::string &name, const long int &seed)
 {
     msg = _("Generating world metadata...");
@@ -24,153 +15,456 @@ void Map::initMetadata(const std::string &name, const long int &seed)
     metadata.generatorName = "default";
     metadata.lastPlayed = -1;
     metadata.name = name;
+    metadata.saveMode = "full";
     metadata.seed = seed;
     metadata.spawnX = static_cast<float>(rng.nextFloat() * MAX_WORLD_GRID_SIZE.x);
     metadata.spawnY = static_cast<float>(rng.nextFloat() * MAX_WORLD_GRID_SIZE.y);
     metadata.timePlayed = 0;
 }
 
-void Map::initTerrainGenerator(const long int &seed)
+void Map::initTerrainGenerator(const long int &seed, const bool generate_spawn)
 {
+    PROFILE_SCOPE("Map::initTerrainGenerator");
+
     std::lock_guard<std::mutex> lock(mutex);
-    terrainGenerator = std::make_unique<TerrainGenerator>(msg, metadata, chunks, seed, texturePack, tileDb, scale);
+    terrainGenerator =
+        std::make_unique<TerrainGenerator>(msg, metadata, chunks, seed, texturePack, tileDb, biomeRules, scale);
+
+    // A new world has nothing on disk yet, so the regions the player starts in are generated on every core up front.
+    if (generate_spawn)
+    {
+        const sf::Vector2i spawn(static_cast<int>(metadata.spawnX), static_cast<int>(metadata.spawnY));
+        const std::vector<sf::Vector2i> spawn_regions = getRegionsInReach(spawn);
+
+        // Only the base terrain: decorations are streamed in once the player is in the world.
+        terrainGenerator->generateRegions(spawn_regions, ChunkStatus::Surface);
+
+        for (const sf::Vector2i &region_index : spawn_regions)
+            chunks.setRegionStatus(region_index, true, false);
+    }
+
     setReady(true);
     clock.restart();
 }
 
-void Map::setReady(const bool ready)
+void Map::initRegionStreamer()
 {
-    this->ready = ready;
+    streamingPosition = sf::Vector2i(-1, -1);
+    streamingTimer = 0.f;
+    streamer = std::make_unique<RegionStreamer>(
+        [this](const sf::Vector2i &region_index) { loadRegion(region_index); },
+        [this](const sf::Vector2i &region_index) { decorateRegion(region_index); },
+        [this](const sf::Vector2i &region_index) { unloadRegion(region_index); },
+        [this](const sf::Vector2i &region_index) { evictRegion(region_index); });
 }
 
-Map::Map(const std::string &name, const long int &seed, TileDatabase &tile_db, sf::Texture &texture_pack,
-         const float &scale)
-    : logger("Map"), ready(false), msg(_("Preparing to load")), folderName(name), tileDb(tile_db),
-      texturePack(texture_pack), scale(scale), rng(seed)
+const float Map::getRegionDistance(const sf::Vector2i &region_index, const sf::Vector2i &grid_pos) const
 {
-    initRegionStatusArray();
-    initMetadata(name, seed);
-    std::thread(&Map::initTerrainGenerator, this, seed).detach();
+    const int REGION_WIDTH = REGION_SIZE_IN_CHUNKS.x * CHUNK_SIZE_IN_TILES.x;
+    const int REGION_HEIGHT = REGION_SIZE_IN_CHUNKS.y * CHUNK_SIZE_IN_TILES.y;
+
+    const int START_X = region_index.x * REGION_WIDTH;
+    const int START_Y = region_index.y * REGION_HEIGHT;
+
+    const int dx = std::max({START_X - grid_pos.x, 0, grid_pos.x - (START_X + REGION_WIDTH - 1)});
+    const int dy = std::max({START_Y - grid_pos.y, 0, grid_pos.y - (START_Y + REGION_HEIGHT - 1)});
+
+    return std::sqrt(static_cast<float>(dx * dx + dy * dy));
 }
 
-Map::Map(TileDatabase &tile_db, sf::Texture &texture_pack, const float &scale)
-    : logger("Map"), ready(false), msg(_("Preparing to load")), folderName("ERROR"), tileDb(tile_db),
-      texturePack(texture_pack), scale(scale), rng(0)
+const std::vector<sf::Vector2i> Map::getRegionsInReach(const sf::Vector2i &grid_pos) const
 {
-    initRegionStatusArray();
-}
+    const int REACH = static_cast<int>(std::ceil(REGION_LOAD_DISTANCE));
 
-Map::~Map() = default;
+    const sf::Vector2i START =
+        ChunkStore::getRegionIndex(TerrainGenerator::getChunkIndex(grid_pos - sf::Vector2i(REACH, REACH)));
+    const sf::Vector2i END =
+        ChunkStore::getRegionIndex(TerrainGenerator::getChunkIndex(grid_pos + sf::Vector2i(REACH, REACH)));
 
-void Map::update(const float &dt, const sf::Vector2i &player_pos_grid)
+    std::vector<sf::Vector2i> regions;
+
+    for (int x = START.x; x <= END.x; x++)
+    {
+        for (int y = START.y; y <= END.y; y++)
+        {
+            if (getRegionDistance({x, y}, grid_pos) <= REGION_LOAD_DISTANCE)
+                regions.push_back({x, y});
+        }
+    }
+
+    return regions;
+}
+
+const bool Map::hasUnsavedChanges(const sf::Vector2i &region_index)
 {
-    if (!isReady())
-        return;
+    const int CHUNK_START_X = region_index.x * static_cast<int>(REGION_SIZE_IN_CHUNKS.x);
+    const int CHUNK_START_Y = region_index.y * static_cast<int>(REGION_SIZE_IN_CHUNKS.y);
 
-    if (player_pos_grid.x < 0 || player_pos_grid.x > MAX_WORLD_GRID_SIZE.x || player_pos_grid.y < 0 ||
-        player_pos_grid.y > MAX_WORLD_GRID_SIZE.y)
-        return;
+    bool unsaved = false;
+
+    // Read under the store mutex, since the main thread edits the epochs.
+    for (int c_x = CHUNK_START_X; c_x < CHUNK_START_X + static_cast<int>(REGION_SIZE_IN_CHUNKS.x); c_x++)
+    {
+        for (int c_y = CHUNK_START_Y; c_y < CHUNK_START_Y + static_cast<int>(REGION_SIZE_IN_CHUNKS.y); c_y++)
+        {
+            chunks.access(sf::Vector2i(c_x, c_y), [&](Chunk &chunk) { unsaved |= chunk.hasUnsavedChanges(); });
+
+            if (unsaved)
+                return true;
+        }
+    }
+
+    return false;
+}
 
-    const int REGION_X = player_pos_grid.x / (REGION_SIZE_IN_CHUNKS.x * CHUNK_SIZE_IN_TILES.x);
-    const int REGION_Y = player_pos_grid.y / (REGION_SIZE_IN_CHUNKS.y * CHUNK_SIZE_IN_TILES.y);
-    std::optional<bool> loaded;
+void Map::queueRegionWrite(const sf::Vector2i &region_index)
+{
+    const int CHUNK_START_X = region_index.x * static_cast<int>(REGION_SIZE_IN_CHUNKS.x);
+    const int CHUNK_START_Y = region_index.y * static_cast<int>(REGION_SIZE_IN_CHUNKS.y);
 
-    loaded = isRegionLoaded({REGION_X, REGION_Y});
-    if (loaded.has_value())
+    if (!std::filesystem::exists(MAPS_FOLDER + metadata.name + "/regions/"))
     {
-        if (loaded.value() == false)
-            std::thread(&Map::loadRegion, this, sf::Vector2i(REGION_X, REGION_Y)).detach();
+        std::filesystem::create_directory(MAPS_FOLDER + metadata.name + "/regions/");
     }
 
-    auto manageRegions = [&](int load_offset_x, int load_offset_y, int unload_offset_x, int unload_offset_y) {
-        sf::Vector2i load_region(REGION_X + load_offset_x, REGION_Y + load_offset_y);
-        sf::Vector2i unload_region(REGION_X + unload_offset_x, REGION_Y + unload_offset_y);
+    std::string path = MAPS_FOLDER + metadata.name + "/regions/r." + std::to_string(region_index.x) + "." +
+                       std::to_string(region_index.y) + ".region";
 
-        if (load_region.x >= 0 && load_region.x < MAX_REGIONS.x && load_region.y >= 0 && load_region.y < MAX_REGIONS.y)
+    RegionRecords records;
+    std::vector<std::pair<unsigned int, ChunkSaveSnapshot>> modified;
+    std::vector<std::pair<sf::Vector2i, uint64_t>> epochs;
+    unsigned long int total_tiles = 0;
+
+    // Only the snapshot of the cells is taken here. Compression and file output run on the region write workers.
+    // It is taken under the store mutex, so an edit on the main thread never lands half-way through a snapshot.
+    for (int c_x = CHUNK_START_X; c_x < CHUNK_START_X + static_cast<int>(REGION_SIZE_IN_CHUNKS.x); c_x++)
+    {
+        for (int c_y = CHUNK_START_Y; c_y < CHUNK_START_Y + static_cast<int>(REGION_SIZE_IN_CHUNKS.y); c_y++)
         {
-            loaded = isRegionLoaded(load_region);
-            if (loaded.has_value())
-            {
-                if (!loaded.value())
-                    std::thread(&Map::loadRegion, this, load_region).detach();
-            }
+            const unsigned int slot = RegionFile::getSlot(sf::Vector2i(c_x, c_y));
+
+            chunks.access(sf::Vector2i(c_x, c_y), [&](Chunk &chunk) {
+                // Deltas are relative to the complete terrain, so edited chunks that weren't decorated yet are
+                // saved whole.
+                if (saveMode == RegionSaveMode::Full ||
+                    (chunk.flags != ChunkFlags::None && chunk.getStatus() != ChunkStatus::Complete))
+                {
+                    total_tiles += chunk.getTileCount();
+                    records[slot] = RegionFile::pack(chunk, tileDb, tileIds);
+                }
+                else if (chunk.flags != ChunkFlags::None)
+                    modified.emplace_back(slot, chunk.takeSaveSnapshot());
+
+                // The chunk only counts as saved at this epoch once the write reached the disk.
+                epochs.emplace_back(chunk.chunkIndex, chunk.getEpoch());
+            });
         }
+    }
 
-        if (unload_region.x >= 0 && unload_region.x < MAX_REGIONS.x && unload_region.y >= 0 &&
-            unload_region.y < MAX_REGIONS.y)
-        {
-            loaded = isRegionLoaded(unload_region);
-            if (loaded.has_value())
+    const std::string table_path = MAPS_FOLDER + metadata.name + "/" + TILE_ID_TABLE_FILENAME;
+
+    // The region may use tile types that were just given a world ID, so the table has to reach the disk first.
+    if (tileIds.isModified())
+        tileIds.save(table_path);
+
+    const size_t delta_count = modified.size();
+
+    // Deltas need the terrain generated again, so they are diffed from snapshots of their cells on the write worker.
+    std::function<void(RegionRecords &)> pack_deltas;
+
+    if (!modified.empty())
+    {
+        pack_deltas = [this, modified = std::move(modified), table_path](RegionRecords &records) {
+            PROFILE_SCOPE("Map::packDeltas");
+
+            for (const auto &[slot, chunk] : modified)
             {
-                if (loaded.value())
-                    std::thread(&Map::unloadRegion, this, unload_region).detach();
+                std::unique_ptr<Chunk> generated = terrainGenerator->generateChunk(chunk.chunkIndex);
+                records[slot] = RegionFile::packDelta(chunk, *generated, tileDb, tileIds);
             }
+
+            if (tileIds.isModified())
+                tileIds.save(table_path);
+        };
+    }
+
+    std::shared_future<bool> written = RegionFile::writeAsync(path, std::move(records), std::move(pack_deltas));
+
+    {
+        std::lock_guard<std::mutex> lock(writesMutex);
+        regionWrites.push_back({region_index, std::move(written), std::move(epochs)});
+    }
+
+    logger.logInfo(_("Queued ") + std::to_string(total_tiles) + _(" tiles and ") + std::to_string(delta_count) +
+                   _(" chunk deltas to be written to region: ") + path);
+}
+
+void Map::queueEvictions(std::vector<RegionTask> &tasks, const sf::Vector2i &player_pos_grid) const
+{
+    size_t usage = chunks.getMemoryUsage();
+
+    for (const ResidentRegion &region : chunks.getLeastRecentlyUsedRegions())
+    {
+        if (usage <= memoryBudget)
+            break;
+
+        const float distance = getRegionDistance(region.regionIndex, player_pos_grid);
+
+        if (distance <= REGION_LOAD_DISTANCE)
+            continue;
+
+        // Out of reach regions are already being unloaded.
+        if (distance <= REGION_UNLOAD_DISTANCE)
+            tasks.push_back({region.regionIndex, RegionTaskType::Evict, distance});
+
+        usage -= std::min(usage, region.memoryUsage);
+    }
+}
+
+void Map::queueMeshBuild(const sf::Vector2i &chunk_index)
+{
+    if (std::find(dirtyChunks.begin(), dirtyChunks.end(), chunk_index) == dirtyChunks.end())
+        dirtyChunks.push_back(chunk_index);
+}
+
+void Map::updateMeshes()
+{
+    PROFILE_SCOPE("Map::updateMeshes");
+
+    for (auto it = meshJobs.begin(); it != meshJobs.end();)
+    {
+        if (it->second.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            it++;
+            continue;
         }
-    };
 
-    const int X_OFFSET = CHUNK_SIZE_IN_TILES.x;
-    const int Y_OFFSET = CHUNK_SIZE_IN_TILES.y;
+        std::optional<std::pair<uint64_t, ChunkMesh>> built = it->second.get();
 
-    if ((player_pos_grid.x + X_OFFSET) / (REGION_SIZE_IN_CHUNKS.x * CHUNK_SIZE_IN_TILES.x) == REGION_X + 1)
+        // Refused if the chunk was patched or snapshotted again meanwhile, as the next build includes these edits.
+        if (built)
+            chunks.access(it->first, [&](Chunk &chunk) { chunk.swapMesh(std::move(built->second), built->first); });
+
+        it = meshJobs.erase(it);
+    }
+
+    for (auto it = dirtyChunks.begin(); it != dirtyChunks.end();)
     {
-        manageRegions(1, -1, -2, -1);
-        manageRegions(1, 0, -2, 0);
-        manageRegions(1, 1, -2, 1);
+        const sf::Vector2i chunk_index = *it;
+
+        // The chunk waits for its current build to be swapped in, then gets the edits made in the meantime.
+        if (std::any_of(meshJobs.begin(), meshJobs.end(), [&](const auto &job) { return job.first == chunk_index; }))
+        {
+            it++;
+            continue;
+        }
+
+        // Only the snapshot is taken under the store lock. The build works on that copy, and the guard keeps the
+        // drawn mesh it starts from alive, so edits and streaming never wait for it.
+        meshJobs.emplace_back(chunk_index, meshPool->enqueue([this, chunk_index]() {
+            PROFILE_SCOPE("Chunk::buildMesh");
+
+            const ChunkStore::ReadGuard guard = chunks.read();
+            std::optional<ChunkMeshSnapshot> snapshot;
+
+            chunks.access(chunk_index, [&](Chunk &chunk) { snapshot = chunk.takeMeshSnapshot(); });
+
+            if (!snapshot)
+                return std::optional<std::pair<uint64_t, ChunkMesh>>();
+
+            return std::make_optional(std::make_pair(snapshot->meshVersion, Chunk::buildMesh(*snapshot)));
+        }));
+
+        it = dirtyChunks.erase(it);
     }
+}
+
+void Map::updateRegionWrites()
+{
+    std::lock_guard<std::mutex> lock(writesMutex);
 
-    if ((player_pos_grid.x - X_OFFSET) / (REGION_SIZE_IN_CHUNKS.x * CHUNK_SIZE_IN_TILES.x) == REGION_X - 1)
+    for (auto it = regionWrites.begin(); it != regionWrites.end();)
     {
-        manageRegions(-1, -1, 2, -1);
-        manageRegions(-1, 0, 2, 0);
-        manageRegions(-1, 1, 2, 1);
+        if (it->written.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            it++;
+            continue;
+        }
+
+        confirmRegionWrite(*it);
+        it = regionWrites.erase(it);
     }
+}
+
+void Map::waitForRegionWrites(const sf::Vector2i &region_index)
+{
+    std::vector<RegionWrite> writes;
 
-    if ((player_pos_grid.y + Y_OFFSET) / (REGION_SIZE_IN_CHUNKS.y * CHUNK_SIZE_IN_TILES.y) == REGION_Y + 1)
+    // Taken out of the list first, so the main thread isn't blocked while they finish.
     {
-        manageRegions(-1, 1, -1, -2);
-        manageRegions(0, 1, 0, -2);
-        manageRegions(1, 1, 1, -2);
+        std::lock_guard<std::mutex> lock(writesMutex);
+
+        for (auto it = regionWrites.begin(); it != regionWrites.end();)
+        {
+            if (it->regionIndex != region_index)
+            {
+                it++;
+                continue;
+            }
+
+            writes.push_back(std::move(*it));
+            it = regionWrites.erase(it);
+        }
     }
 
-    if ((player_pos_grid.y - Y_OFFSET) / (REGION_SIZE_IN_CHUNKS.y * CHUNK_SIZE_IN_TILES.y) == REGION_Y - 1)
+    // Writes of the same file are applied in order, so a later write that succeeded covers an earlier one that
+    // failed.
+    for (const RegionWrite &write : writes)
+        confirmRegionWrite(write);
+}
+
+void Map::confirmRegionWrite(const RegionWrite &write)
+{
+    if (!write.written.get())
     {
-        manageRegions(-1, -1, -1, 2);
-        manageRegions(0, -1, 0, 2);
-        manageRegions(1, -1, 1, 2);
+        logger.logError(_("Failed to save region (") + std::to_string(write.regionIndex.x) + ", " +
+                            std::to_string(write.regionIndex.y) + _("), its changes are kept in memory."),
+                        false);
+        return;
     }
+
+    for (const auto &[chunk_index, epoch] : write.epochs)
+        chunks.access(chunk_index, [&, epoch = epoch](Chunk &chunk) { chunk.markSaved(epoch); });
 }
 
-void Map::render(sf::RenderTarget &target, const bool &debug)
+void Map::setReady(const bool ready)
+{
+    this->ready = ready;
+}
+
+Map::Map(const std::string &name, const long int &seed, TileDatabase &tile_db, const BiomeRules &biome_rules,
+         sf::Texture &texture_pack, const float &scale)
+    : logger("Map"), ready(false), msg(_("Preparing to load")), folderName(name), tileDb(tile_db),
+      biomeRules(biome_rules), texturePack(texture_pack), scale(scale),
+      memoryBudget(static_cast<size_t>(DEFAULT_CHUNK_MEMORY_BUDGET) * 1024 * 1024), saveMode(RegionSaveMode::Full),
+      rng(seed), renderStats({0, 0}), meshPool(std::make_unique<ThreadPool>(MESH_WORKER_COUNT, "Mesh builder"))
 {
+    initMetadata(name, seed);
+    initRegionStreamer();
+    std::thread(&Map::initTerrainGenerator, this, seed, true).detach();
+}
+
+Map::Map(TileDatabase &tile_db, const BiomeRules &biome_rules, sf::Texture &texture_pack, const float &scale)
+    : logger("Map"), ready(false), msg(_("Preparing to load")), folderName("ERROR"), tileDb(tile_db),
+      biomeRules(biome_rules), texturePack(texture_pack), scale(scale),
+      memoryBudget(static_cast<size_t>(DEFAULT_CHUNK_MEMORY_BUDGET) * 1024 * 1024), saveMode(RegionSaveMode::Full),
+      rng(0), renderStats({0, 0}), meshPool(std::make_unique<ThreadPool>(MESH_WORKER_COUNT, "Mesh builder"))
+{
+    initRegionStreamer();
+}
+
+Map::~Map()
+{
+    // Delta writes still queued generate terrain and use the tile ID table, so they have to finish first. The
+    // streamer goes first, since unloading queues writes too.
+    streamer.reset();
+    RegionFile::waitForWrites();
+}
+
+void Map::update(const float &dt, const sf::Vector2i &player_pos_grid)
+{
+    PROFILE_SCOPE("Map::update");
+
     if (!isReady())
         return;
 
-    for (auto &row : chunks)
+    chunks.tick();
+    updateMeshes();
+    updateRegionWrites();
+
+    streamingTimer += dt;
+
+    // Also rescheduled on an interval while the player stands still, so evictions don't wait for them to move.
+    if (player_pos_grid == streamingPosition && streamingTimer < REGION_STREAMING_INTERVAL)
+        return;
+
+    streamingPosition = player_pos_grid;
+    streamingTimer = 0.f;
+
+    std::vector<RegionTask> tasks;
+
+    // Only the loaded regions and the ones in reach of the player are visited, however large the world is.
+    for (const sf::Vector2i &region_index : chunks.getLoadedRegions())
     {
-        for (auto &chunk : row)
-        {
-            if (chunk)
-                target.draw(*chunk);
-        }
+        const float distance = getRegionDistance(region_index, player_pos_grid);
+
+        if (distance > REGION_UNLOAD_DISTANCE)
+            tasks.push_back({region_index, RegionTaskType::Unload, distance});
+        else if (!chunks.isRegionComplete(region_index) && distance <= REGION_LOAD_DISTANCE)
+            tasks.push_back({region_index, RegionTaskType::Decorate, distance + REGION_DECORATION_PRIORITY_OFFSET});
     }
+
+    for (const sf::Vector2i &region_index : getRegionsInReach(player_pos_grid))
+    {
+        if (chunks.isRegionLoaded(region_index))
+            continue;
+
+        const float distance = getRegionDistance(region_index, player_pos_grid);
+
+        // Runs after the load, since a region only ever has one operation running at a time.
+        tasks.push_back({region_index, RegionTaskType::Load, distance});
+        tasks.push_back({region_index, RegionTaskType::Decorate, distance + REGION_DECORATION_PRIORITY_OFFSET});
+    }
+
+    queueEvictions(tasks, player_pos_grid);
+
+    // Requests from the previous position that are still waiting are replaced, so stale loads never run.
+    streamer->schedule(std::move(tasks));
+}
+
+void Map::render(sf::RenderTarget &target, const bool &debug)
+{
+    render(target, target.getView(), debug);
 }
 
-void Map::render(sf::RenderTarget &target, const sf::Vector2i &entity_pos_grid, const bool &debug)
+void Map::render(sf::RenderTarget &target, const sf::View &view, const bool &debug)
 {
+    PROFILE_SCOPE("Map::render");
+
+    renderStats = {0, 0};
+
     if (!isReady())
         return;
 
-    const int chunk_x = entity_pos_grid.x / CHUNK_SIZE_IN_TILES.x;
-    const int chunk_y = entity_pos_grid.y / CHUNK_SIZE_IN_TILES.y;
+    // Bounds of the whole view in world space, so zoomed or rotated views are covered too.
+    const sf::FloatRect bounds = view.getInverseTransform().transformRect(sf::FloatRect({-1.f, -1.f}, {2.f, 2.f}));
+
+    const float CHUNK_WIDTH = CHUNK_SIZE_IN_TILES.x * GRID_SIZE * scale;
+    const float CHUNK_HEIGHT = CHUNK_SIZE_IN_TILES.y * GRID_SIZE * scale;
+
+    const int START_X = static_cast<int>(std::floor(bounds.position.x / CHUNK_WIDTH));
+    const int START_Y = static_cast<int>(std::floor(bounds.position.y / CHUNK_HEIGHT));
+    const int END_X = static_cast<int>(std::floor((bounds.position.x + bounds.size.x) / CHUNK_WIDTH));
+    const int END_Y = static_cast<int>(std::floor((bounds.position.y + bounds.size.y) / CHUNK_HEIGHT));
+
+    // Streaming threads may replace or erase chunks while they are drawn: the old ones are kept until this ends.
+    const ChunkStore::ReadGuard guard = chunks.read();
 
-    for (int i = -1; i <= 1; i++)
+    for (int x = START_X; x <= END_X; x++)
     {
-        for (int j = -1; j <= 1; j++)
+        for (int y = START_Y; y <= END_Y; y++)
         {
-            if (chunk_x + i < 0 || chunk_y + j < 0 || chunk_x + i >= MAX_CHUNKS.x || chunk_y + j >= MAX_CHUNKS.y)
+            Chunk *chunk = chunks.get(sf::Vector2i(x, y));
+            if (!chunk)
                 continue;
-            if (chunks[chunk_x + i][chunk_y + j])
-                target.draw(*chunks[chunk_x + i][chunk_y + j]);
+
+            target.draw(*chunk);
+
+            if (debug)
+                target.draw(chunk->chunkBorders);
+
+            renderStats.drawnChunks++;
+            renderStats.vertexCount += chunk->getVertexCount();
         }
     }
 }
@@ -193,29 +487,27 @@ void Map::save(const std::string &name)
     JObject metadataObj;
     metadataObj << metadata;
 
-    std::ofstream metadataFile(path_str + "metadata.json");
+    // Write next to the metadata and rename it over, so a crash never leaves a truncated file.
+    std::ofstream metadataFile(path_str + "metadata.json.tmp");
     if (!metadataFile.is_open())
         logger.logError(_("Could not write world metadata: ") + path_str + "metadata.json");
 
     metadataFile << JSON::stringify(metadataObj);
     metadataFile.close();
 
-    for (int i = 0; i < MAX_REGIONS.x; i++)
-    {
-        for (int j = 0; j < MAX_REGIONS.y; j++)
-        {
-            const auto loaded = isRegionLoaded({i, j});
-            if (loaded.has_value())
-            {
-                if (loaded.value())
-                    saveRegion({i, j});
-            }
-        }
-    }
+    std::filesystem::rename(path_str + "metadata.json.tmp", path_str + "metadata.json");
+
+    if (tileIds.isModified())
+        tileIds.save(path_str + TILE_ID_TABLE_FILENAME);
+
+    for (const sf::Vector2i &region_index : chunks.getLoadedRegions())
+        saveRegion(region_index);
 }
 
 void Map::save()
 {
+    PROFILE_SCOPE("Map::save");
+
     if (!isReady())
         return;
 
@@ -226,85 +518,17 @@ void Map::save()
 
 void Map::saveRegion(const sf::Vector2i &region_index)
 {
-    if (!isReady() || region_index.x < 0 || region_index.x >= MAX_REGIONS.x || region_index.y < 0 ||
-        region_index.y >= MAX_REGIONS.y)
-        return;
+    PROFILE_SCOPE("Map::saveRegion");
 
-    const auto loaded = isRegionLoaded(region_index);
-    if (!loaded.has_value())
-        return;
-
-    if (!loaded.value())
+    if (!isReady())
         return;
 
-    const int CHUNK_START_X = region_index.x * REGION_SIZE_IN_CHUNKS.x;
-    const int CHUNK_START_Y = region_index.y * REGION_SIZE_IN_CHUNKS.y;
-    const int CHUNK_END_X = (CHUNK_START_X + REGION_SIZE_IN_CHUNKS.x) - 1;
-    const int CHUNK_END_Y = (CHUNK_START_Y + REGION_SIZE_IN_CHUNKS.y) - 1;
-
-    if (!std::filesystem::exists(MAPS_FOLDER + metadata.name + "/regions/"))
-    {
-        std::filesystem::create_directory(MAPS_FOLDER + metadata.name + "/regions/");
-    }
-
-    std::string path = MAPS_FOLDER + metadata.name + "/regions/r." + std::to_string(region_index.x) + "." +
-                       std::to_string(region_index.y) + ".region";
-    std::ofstream region_file(path, std::ios::binary);
-    if (!region_file.is_open())
-        logger.logError(_("Failed to write region file: ") + path);
-
-    unsigned long int total_tiles = 0;
-
-    for (unsigned short c_x = CHUNK_START_X; c_x <= CHUNK_END_X; c_x++)
-    {
-        for (unsigned short c_y = CHUNK_START_Y; c_y <= CHUNK_END_Y; c_y++)
-        {
-            if (!chunks[c_x][c_y])
-                continue;
-
-            unsigned short tile_amount = 0;
-            for (auto &x : chunks[c_x][c_y]->tiles)
-            {
-                for (auto &y : x)
-                {
-                    for (auto &tile : y)
-                    {
-                        if (tile)
-                            tile_amount++;
-                    }
-                }
-            }
-
-            total_tiles += tile_amount;
-
-            region_file.write(reinterpret_cast<char *>(&c_x), sizeof(unsigned short));
-            region_file.write(reinterpret_cast<char *>(&c_y), sizeof(unsigned short));
-            region_file.write(reinterpret_cast<char *>(&chunks[c_x][c_y]->flags), sizeof(chunks[c_x][c_y]->flags));
-            region_file.write(reinterpret_cast<char *>(&tile_amount), sizeof(unsigned short));
+    std::lock_guard<std::mutex> lock(mutex);
 
-            for (unsigned short x = 0; x < CHUNK_SIZE_IN_TILES.x; x++)
-            {
-                for (unsigned short y = 0; y < CHUNK_SIZE_IN_TILES.y; y++)
-                {
-                    for (unsigned short z = 0; z < CHUNK_SIZE_IN_TILES.z; z++)
-                    {
-                        if (!chunks[c_x][c_y]->tiles[x][y][z])
-                            continue;
-
-                        uint64_t id = chunks[c_x][c_y]->tiles[x][y][z]->getId();
-
-                        region_file.write(reinterpret_cast<char *>(&id), sizeof(uint64_t));
-                        region_file.write(reinterpret_cast<char *>(&x), sizeof(unsigned short));
-                        region_file.write(reinterpret_cast<char *>(&y), sizeof(unsigned short));
-                        region_file.write(reinterpret_cast<char *>(&z), sizeof(unsigned short));
-                    }
-                }
-            }
-        }
-    }
+    if (!chunks.isRegionLoaded(region_index) || !hasUnsavedChanges(region_index))
+        return;
 
-    region_file.close();
-    logger.logInfo(_("Written ") + std::to_string(total_tiles) + _(" tiles to region: ") + path);
+    queueRegionWrite(region_index);
 }
 
 void Map::load(const std::string &name)
@@ -333,261 +557,348 @@ void Map::load(const std::string &name)
     metadataObj >> metadata;
     metadataFile.close();
 
+    if (metadata.saveMode == "delta")
+        saveMode = RegionSaveMode::Delta;
+    else if (metadata.saveMode == "full")
+        saveMode = RegionSaveMode::Full;
+    else
+        logger.logWarning(_("Unknown save mode, saving in full: ") + metadata.saveMode);
+
+    // Worlds saved before the table existed get one when their region files are upgraded.
+    if (std::filesystem::exists(path_str + TILE_ID_TABLE_FILENAME) &&
+        !tileIds.load(path_str + TILE_ID_TABLE_FILENAME, tileDb))
+        logger.logError(_("Failed to load tile ID table: ") + path_str + TILE_ID_TABLE_FILENAME);
+
     msg = _("Initializing terrain generator...");
-    std::thread(&Map::initTerrainGenerator, this, metadata.seed).detach();
+    std::thread(&Map::initTerrainGenerator, this, metadata.seed, false).detach();
 }
 
 void Map::loadRegion(const sf::Vector2i &region_index)
 {
-    std::lock_guard<std::mutex> lock(mutex);
+    PROFILE_SCOPE("Map::loadRegion");
 
-    if (!isReady() || region_index.x < 0 || region_index.x >= MAX_REGIONS.x || region_index.y < 0 ||
-        region_index.y >= MAX_REGIONS.y)
+    // The streamer never runs two operations on the same region at once, and regions don't share chunks, so the
+    // generation and the file reading don't need the lock. Only installing the chunks does.
+    if (!isReady() || isRegionLoaded(region_index))
         return;
 
-    std::optional<bool> loaded = isRegionLoaded(region_index);
-    if (loaded.has_value())
+    std::string path = MAPS_FOLDER + metadata.name + "/regions/r." + std::to_string(region_index.x) + "." +
+                       std::to_string(region_index.y) + ".region";
+
+    // The region may have been saved right before being unloaded, and the file may not even exist yet.
+    RegionFile::waitForWrites(path);
+
+    // Only the base terrain, so the region is playable as soon as possible. A decoration task finishes it.
+    if (!std::filesystem::exists(path))
     {
-        if (loaded.value() == true)
-            return;
+        terrainGenerator->generateRegion(region_index, ChunkStatus::Surface);
+        chunks.setRegionStatus(region_index, true, false);
+        return;
     }
-    else
+
+    RegionRecords records;
+
+    // This runs on a streamer worker, so errors are logged without throwing. A region that can't be read is left
+    // unloaded rather than generated again, so its file is never overwritten.
+    const uint16_t version = RegionFile::getVersion(path);
+
+    if (version > REGION_FILE_VERSION)
+    {
+        logger.logError(_("Region file was written by a newer version of the game: ") + path, false);
         return;
+    }
 
-    std::string path = MAPS_FOLDER + metadata.name + "/regions/r." + std::to_string(region_index.x) + "." +
-                       std::to_string(region_index.y) + ".region";
+    if (version != REGION_FILE_VERSION)
+    {
+        logger.logInfo(_("Upgrading region file: ") + path);
+
+        if (!RegionFile::upgrade(path, records, tileDb, tileIds))
+        {
+            logger.logError(_("Failed to upgrade region file: ") + path, false);
+            return;
+        }
+
+        // The upgraded chunks reference the world IDs they were just given, so the table is saved first.
+        tileIds.save(MAPS_FOLDER + metadata.name + "/" + TILE_ID_TABLE_FILENAME);
 
-    if (!loaded.value() && !std::filesystem::exists(path))
+        // The records are loaded either way, and the upgrade is tried again next time.
+        if (!RegionFile::write(path, records))
+            logger.logError(_("Failed to write region file: ") + path, false);
+    }
+    else if (!RegionFile::read(path, records))
     {
-        terrainGenerator->generateRegion(region_index);
-        loadedRegions[region_index.x][region_index.y] = true;
+        logger.logError(_("Failed to read region file: ") + path, false);
         return;
     }
 
-    std::ifstream region_file(path, std::ios::binary);
-    if (!region_file.is_open())
-        logger.logError(_("Failed to read region file: ") + path);
+    const int CHUNK_START_X = region_index.x * static_cast<int>(REGION_SIZE_IN_CHUNKS.x);
+    const int CHUNK_START_Y = region_index.y * static_cast<int>(REGION_SIZE_IN_CHUNKS.y);
 
-    unsigned long total_tiles = 0;
-    unsigned short chunk_x = 0, chunk_y = 0, tile_amount = 0;
-    uint8_t flags;
+    // Chunks are built from their records before being stored, so readers never find one half-read.
+    std::array<std::unique_ptr<Chunk>, REGION_CHUNK_COUNT> built;
+    bool missing = false, incomplete = false;
 
-    while (region_file.read(reinterpret_cast<char *>(&chunk_x), sizeof(unsigned short)) &&
-           region_file.read(reinterpret_cast<char *>(&chunk_y), sizeof(unsigned short)) &&
-           region_file.read(reinterpret_cast<char *>(&flags), sizeof(uint8_t)) &&
-           region_file.read(reinterpret_cast<char *>(&tile_amount), sizeof(unsigned short)))
+    for (unsigned int slot = 0; slot < REGION_CHUNK_COUNT; slot++)
     {
-        if (chunk_x < 0 || chunk_x >= MAX_CHUNKS.x || chunk_y < 0 || chunk_y >= MAX_CHUNKS.y)
-            logger.logError(_("Corrupted region file: Chunk index out of bounds"));
+        if (!records[slot].has_value())
+        {
+            missing = true;
+            continue;
+        }
+
+        const sf::Vector2i chunk_index(CHUNK_START_X + static_cast<int>(slot % REGION_SIZE_IN_CHUNKS.x),
+                                       CHUNK_START_Y + static_cast<int>(slot / REGION_SIZE_IN_CHUNKS.x));
 
-        if (!chunks[chunk_x][chunk_y])
+        std::unique_ptr<Chunk> chunk;
+
+        // Delta saves leave out the generated terrain, so the record is applied on top of it. The generated chunk
+        // comes with its batch open.
+        if (records[slot]->delta)
+        {
+            chunk = terrainGenerator->generateChunk(chunk_index);
+            chunk->flags = records[slot]->flags;
+        }
+        else
         {
-            chunks[chunk_x][chunk_y] =
-                std::make_unique<Chunk>(texturePack, sf::Vector2u(chunk_x, chunk_y), scale, flags);
+            chunk = std::make_unique<Chunk>(texturePack, chunk_index, scale, records[slot]->flags);
+            chunk->beginBatch();
         }
 
-        for (int i = 0; i < tile_amount; i++)
+        RegionFile::unpack(records[slot].value(), *chunk, tileDb, tileIds);
+        chunk->markSaved(chunk->getEpoch());
+
+        std::shared_ptr<const ChunkClimate> climate = terrainGenerator->getClimate(chunk_index);
+
+        for (unsigned int x = 0; x < CHUNK_SIZE_IN_TILES.x; x++)
         {
-            unsigned short x = 0, y = 0, z = 0;
-            uint64_t id;
+            for (unsigned int y = 0; y < CHUNK_SIZE_IN_TILES.y; y++)
+                chunk->setTint(x, y, climate->tints[y * CHUNK_SIZE_IN_TILES.x + x]);
+        }
 
-            region_file.read(reinterpret_cast<char *>(&id), sizeof(uint64_t));
-            region_file.read(reinterpret_cast<char *>(&x), sizeof(unsigned short));
-            region_file.read(reinterpret_cast<char *>(&y), sizeof(unsigned short));
-            region_file.read(reinterpret_cast<char *>(&z), sizeof(unsigned short));
+        chunk->endBatch();
+        chunk->setStatus(records[slot]->status);
 
-            if (x > CHUNK_SIZE_IN_TILES.x || y > CHUNK_SIZE_IN_TILES.y || z > CHUNK_SIZE_IN_TILES.z)
-                logger.logError(_("Corrupted region file: ") + "Tile[" + std::to_string(x) + "][" + std::to_string(y) +
-                                "][" + std::to_string(z) + "] " + _("out of bounds in Chunk") + "[" +
-                                std::to_string(chunk_x) + "][" + std::to_string(chunk_y) + "]");
+        if (records[slot]->status != ChunkStatus::Complete)
+            incomplete = true;
 
-            TileData td = tileDb.getById(id);
+        built[slot] = std::move(chunk);
+    }
 
-            sf::Vector2i grid_pos(x + (chunk_x * CHUNK_SIZE_IN_TILES.x), y + (chunk_y * CHUNK_SIZE_IN_TILES.y));
-            BiomePreset biome_data = terrainGenerator->getBiomeData(grid_pos);
+    unsigned long total_tiles = 0;
 
-            if (td.tag != "unknown")
-            {
-                chunks[chunk_x][chunk_y]->tiles[x][y][z] = std::make_unique<Tile>(
-                    td.name, td.tag, td.id, texturePack, td.rect, grid_pos, scale, biome_data.color);
-            }
-            else
-            {
-                logger.logWarning(_("Invalid tile ID: ") + std::to_string(id) + " Tile[" + std::to_string(x) + "][" +
-                                  std::to_string(y) + "][" + std::to_string(z) + "]" + _(" in Chunk") + "[" +
-                                  std::to_string(chunk_x) + "][" + std::to_string(chunk_y) + "]");
+    {
+        std::lock_guard<std::mutex> lock(mutex);
 
-                chunks[chunk_x][chunk_y]->tiles[x][y][z] =
-                    std::make_unique<Tile>(td.name, td.tag, td.id, texturePack, td.rect, grid_pos, scale);
-            }
-        }
+        for (unsigned int slot = 0; slot < REGION_CHUNK_COUNT; slot++)
+        {
+            if (!built[slot])
+                continue;
 
-        chunks[chunk_x][chunk_y]->updateVertexArray();
+            const sf::Vector2i chunk_index(CHUNK_START_X + static_cast<int>(slot % REGION_SIZE_IN_CHUNKS.x),
+                                           CHUNK_START_Y + static_cast<int>(slot / REGION_SIZE_IN_CHUNKS.x));
+            const unsigned int tile_count = built[slot]->getTileCount();
 
-        total_tiles += tile_amount;
+            // A chunk that stayed resident (e.g. kept loaded) is at least as recent as its file, and is kept.
+            if (chunks.insert(chunk_index, std::move(built[slot])))
+                total_tiles += tile_count;
+        }
     }
 
-    region_file.close();
-    loadedRegions[region_index.x][region_index.y] = true;
+    // Chunks the file doesn't hold were never changed, so only their base terrain is generated. Like chunks saved
+    // before being decorated, the decoration task finishes them.
+    if (missing)
+        terrainGenerator->generateRegion(region_index, ChunkStatus::Surface);
+
+    chunks.setRegionStatus(region_index, true, !missing && !incomplete);
     logger.logInfo(_("Read ") + std::to_string(total_tiles) + _(" tiles from region: ") + path);
 }
 
-void Map::unloadRegion(const sf::Vector2i &region_index)
+void Map::decorateRegion(const sf::Vector2i &region_index)
 {
-    std::lock_guard<std::mutex> lock(mutex);
+    PROFILE_SCOPE("Map::decorateRegion");
 
+    // Like loading, decoration doesn't need the lock: the streamer never runs two operations on the same region at
+    // once, and the chunks are advanced on copies that a save of the region never waits for.
     if (!isReady())
         return;
 
-    std::optional<bool> loaded = isRegionLoaded(region_index);
-    if (loaded.has_value())
+    // The region may have been unloaded, or loaded from disk, since the task was queued.
+    if (!chunks.isRegionLoaded(region_index) || chunks.isRegionComplete(region_index))
+        return;
+
+    terrainGenerator->generateRegion(region_index);
+    chunks.setRegionStatus(region_index, true, true);
+}
+
+const bool Map::unloadRegion(const sf::Vector2i &region_index)
+{
+    PROFILE_SCOPE("Map::unloadRegion");
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (!isReady())
+        return false;
+
+    if (!isRegionLoaded(region_index))
+        return false;
+
+    // The region is marked unloaded first, which refuses its edits from now on, so nothing changes after the snapshot.
+    const bool complete = chunks.isRegionComplete(region_index);
+    chunks.setRegionStatus(region_index, false, false);
+
+    // Clean regions can be dropped as they are: they match their file, or can be generated again.
+    if (hasUnsavedChanges(region_index))
+        queueRegionWrite(region_index);
+
+    // Saves queued earlier may still be running too. If any change didn't reach the disk, the region is loaded
+    // again, and the next unload writes it again.
+    waitForRegionWrites(region_index);
+
+    if (hasUnsavedChanges(region_index))
     {
-        if (loaded.value() == false)
-            return;
+        chunks.setRegionStatus(region_index, true, complete);
+        return false;
     }
-    else
-        return;
 
-    const int CHUNK_START_X = region_index.x * REGION_SIZE_IN_CHUNKS.x;
-    const int CHUNK_START_Y = region_index.y * REGION_SIZE_IN_CHUNKS.y;
-    const int CHUNK_END_X = (CHUNK_START_X + REGION_SIZE_IN_CHUNKS.x) - 1;
-    const int CHUNK_END_Y = (CHUNK_START_Y + REGION_SIZE_IN_CHUNKS.y) - 1;
+    const int CHUNK_START_X = region_index.x * static_cast<int>(REGION_SIZE_IN_CHUNKS.x);
+    const int CHUNK_START_Y = region_index.y * static_cast<int>(REGION_SIZE_IN_CHUNKS.y);
+    const int CHUNK_END_X = (CHUNK_START_X + static_cast<int>(REGION_SIZE_IN_CHUNKS.x)) - 1;
+    const int CHUNK_END_Y = (CHUNK_START_Y + static_cast<int>(REGION_SIZE_IN_CHUNKS.y)) - 1;
+
+    const ChunkStore::ReadGuard guard = chunks.read();
 
-    for (unsigned short c_x = CHUNK_START_X; c_x <= CHUNK_END_X; c_x++)
+    for (int c_x = CHUNK_START_X; c_x <= CHUNK_END_X; c_x++)
     {
-        for (unsigned short c_y = CHUNK_START_Y; c_y <= CHUNK_END_Y; c_y++)
+        for (int c_y = CHUNK_START_Y; c_y <= CHUNK_END_Y; c_y++)
         {
-            if (chunks[c_x][c_y] && !(chunks[c_x][c_y]->flags & ChunkFlags::KeepLoaded) &&
-                !(chunks[c_x][c_y]->flags & ChunkFlags::Modified))
-            {
-                chunks[c_x][c_y].reset();
-            }
+            Chunk *chunk = chunks.get(sf::Vector2i(c_x, c_y));
+            if (chunk && !(chunk->flags & ChunkFlags::KeepLoaded))
+                chunks.erase(sf::Vector2i(c_x, c_y));
         }
     }
 
-    loadedRegions[region_index.x][region_index.y] = false;
     logger.logInfo(_("Region (") + std::to_string(region_index.x) + ", " + std::to_string(region_index.y) +
                    _(") unloaded from memory."));
+
+    return true;
 }
 
-void Map::putTile(Tile tile, const int &grid_x, const int &grid_y, const int &grid_z)
+void Map::evictRegion(const sf::Vector2i &region_index)
 {
-    if (grid_x < 0 || grid_x >= MAX_WORLD_GRID_SIZE.x || grid_y < 0 || grid_y >= MAX_WORLD_GRID_SIZE.y || grid_z < 0 ||
-        grid_z >= CHUNK_SIZE_IN_TILES.z)
+    PROFILE_SCOPE("Map::evictRegion");
+
+    // The region may have been unloaded since the task was queued.
+    if (!isReady() || !chunks.isRegionLoaded(region_index))
         return;
 
-    const unsigned int chunk_x = grid_x / CHUNK_SIZE_IN_TILES.x;
-    const unsigned int chunk_y = grid_y / CHUNK_SIZE_IN_TILES.y;
+    if (unloadRegion(region_index))
+        chunks.recordEviction();
+}
+
+const bool Map::putTile(const TileData &tile_data, const int &grid_x, const int &grid_y, const int &grid_z)
+{
+    if (grid_z < 0 || grid_z >= CHUNK_SIZE_IN_TILES.z)
+        return false;
 
-    const unsigned int tile_x = grid_x - (chunk_x * CHUNK_SIZE_IN_TILES.x);
-    const unsigned int tile_y = grid_y - (chunk_y * CHUNK_SIZE_IN_TILES.y);
+    const sf::Vector2i chunk_index = TerrainGenerator::getChunkIndex({grid_x, grid_y});
+    const sf::Vector2u tile = TerrainGenerator::getTileIndex({grid_x, grid_y});
 
-    tile.setGridPosition(sf::Vector2u(grid_x, grid_y));
+    bool placed = false;
 
-    if (!chunks[chunk_x][chunk_y])
-        chunks[chunk_x][chunk_y] = std::make_unique<Chunk>(texturePack, sf::Vector2u(chunk_x, chunk_y), scale);
+    // Edits go through the store, so a worker advancing a copy of the chunk never drops them. Chunks of regions that
+    // aren't loaded are refused rather than created: loading their region would keep the empty chunk over its file.
+    chunks.edit(chunk_index, [&](Chunk &chunk) {
+        placed = chunk.putTile(tile_data, tile.x, tile.y, grid_z);
 
-    if (!chunks[chunk_x][chunk_y]->tiles[tile_x][tile_y][grid_z])
-    {
-        chunks[chunk_x][chunk_y]->tiles[tile_x][tile_y][grid_z] = std::make_unique<Tile>(tile);
-        chunks[chunk_x][chunk_y]->updateVertexArray();
-    }
+        if (placed)
+            chunk.flags |= ChunkFlags::Modified;
+    });
+
+    if (placed)
+        queueMeshBuild(chunk_index);
+
+    return placed;
 }
 
-Tile *Map::getTile(const int &grid_x, const int &grid_y, const int &grid_z)
+std::optional<Tile> Map::getTile(const int &grid_x, const int &grid_y, const int &grid_z)
 {
-    if (grid_x < 0 || grid_y < 0 || grid_z < 0 || grid_x >= MAX_WORLD_GRID_SIZE.x || grid_y >= MAX_WORLD_GRID_SIZE.y ||
-        grid_z > CHUNK_SIZE_IN_TILES.z)
-        return nullptr;
+    if (grid_z < 0 || grid_z >= CHUNK_SIZE_IN_TILES.z)
+        return std::nullopt;
 
-    const unsigned int chunk_x = grid_x / CHUNK_SIZE_IN_TILES.x;
-    const unsigned int chunk_y = grid_y / CHUNK_SIZE_IN_TILES.y;
+    const sf::Vector2i chunk_index = TerrainGenerator::getChunkIndex({grid_x, grid_y});
+    const sf::Vector2u tile = TerrainGenerator::getTileIndex({grid_x, grid_y});
 
-    const unsigned int tile_x = grid_x - (chunk_x * CHUNK_SIZE_IN_TILES.x);
-    const unsigned int tile_y = grid_y - (chunk_y * CHUNK_SIZE_IN_TILES.y);
+    const ChunkStore::ReadGuard guard = chunks.read();
 
-    if (!chunks[chunk_x][chunk_y] || !chunks[chunk_x][chunk_y]->tiles[tile_x][tile_y][grid_z])
-        return nullptr;
+    Chunk *chunk = chunks.get(chunk_index);
+    if (!chunk)
+        return std::nullopt;
 
-    return chunks[chunk_x][chunk_y]->tiles[tile_x][tile_y][grid_z].get();
+    return chunk->getTile(tile.x, tile.y, grid_z);
 }
 
-Tile *Map::getTile(const int &grid_x, const int &grid_y)
+std::optional<Tile> Map::getTile(const int &grid_x, const int &grid_y)
 {
-    if (grid_x < 0 || grid_y < 0 || grid_x >= MAX_WORLD_GRID_SIZE.x || grid_y >= MAX_WORLD_GRID_SIZE.y)
-        return nullptr;
-
-    const unsigned int chunk_x = grid_x / CHUNK_SIZE_IN_TILES.x;
-    const unsigned int chunk_y = grid_y / CHUNK_SIZE_IN_TILES.y;
+    const sf::Vector2i chunk_index = TerrainGenerator::getChunkIndex({grid_x, grid_y});
+    const sf::Vector2u tile = TerrainGenerator::getTileIndex({grid_x, grid_y});
 
-    const unsigned int tile_x = grid_x - (chunk_x * CHUNK_SIZE_IN_TILES.x);
-    const unsigned int tile_y = grid_y - (chunk_y * CHUNK_SIZE_IN_TILES.y);
+    const ChunkStore::ReadGuard guard = chunks.read();
 
-    if (!chunks[chunk_x][chunk_y] || chunks[chunk_x][chunk_y]->tiles[tile_x][tile_y].empty())
-        return nullptr;
+    Chunk *chunk = chunks.get(chunk_index);
+    if (!chunk)
+        return std::nullopt;
 
-    for (int i = chunks[chunk_x][chunk_y]->tiles[tile_x][tile_y].size() - 1; i >= 0; i--)
-    {
-        if (chunks[chunk_x][chunk_y]->tiles[tile_x][tile_y][i])
-        {
-            return chunks[chunk_x][chunk_y]->tiles[tile_x][tile_y][i].get();
-        }
-    }
+    const int top_layer = chunk->getTopLayer(tile.x, tile.y);
+    if (top_layer < 0)
+        return std::nullopt;
 
-    return nullptr;
+    return chunk->getTile(tile.x, tile.y, top_layer);
 }
 
 const bool Map::removeTile(const int &grid_x, const int &grid_y, const int &grid_z)
 {
-    if (grid_x < 0 || grid_x >= MAX_WORLD_GRID_SIZE.x || grid_y < 0 || grid_y >= MAX_WORLD_GRID_SIZE.y || grid_z < 0 ||
-        grid_z >= CHUNK_SIZE_IN_TILES.z)
+    if (grid_z < 0 || grid_z >= CHUNK_SIZE_IN_TILES.z)
         return false;
 
-    const unsigned int chunk_x = grid_x / CHUNK_SIZE_IN_TILES.x;
-    const unsigned int chunk_y = grid_y / CHUNK_SIZE_IN_TILES.y;
+    const sf::Vector2i chunk_index = TerrainGenerator::getChunkIndex({grid_x, grid_y});
+    const sf::Vector2u tile = TerrainGenerator::getTileIndex({grid_x, grid_y});
 
-    const unsigned int tile_x = grid_x - (chunk_x * CHUNK_SIZE_IN_TILES.x);
-    const unsigned int tile_y = grid_y - (chunk_y * CHUNK_SIZE_IN_TILES.y);
+    bool removed = false;
 
-    if (!chunks[chunk_x][chunk_y])
-        return false;
+    chunks.edit(chunk_index, [&](Chunk &chunk) {
+        removed = chunk.removeTile(tile.x, tile.y, grid_z);
 
-    if (!chunks[chunk_x][chunk_y]->tiles[tile_x][tile_y][grid_z])
-        return false;
+        if (removed)
+            chunk.flags |= ChunkFlags::Modified;
+    });
 
-    chunks[chunk_x][chunk_y]->tiles[tile_x][tile_y][grid_z].reset();
-    chunks[chunk_x][chunk_y]->updateVertexArray();
-    return true;
+    if (removed)
+        queueMeshBuild(chunk_index);
+
+    return removed;
 }
 
 const bool Map::removeTile(const int &grid_x, const int &grid_y)
 {
-    if (grid_x < 0 || grid_x >= MAX_WORLD_GRID_SIZE.x || grid_y < 0 || grid_y >= MAX_WORLD_GRID_SIZE.y)
-        return false;
+    const sf::Vector2i chunk_index = TerrainGenerator::getChunkIndex({grid_x, grid_y});
+    const sf::Vector2u tile = TerrainGenerator::getTileIndex({grid_x, grid_y});
 
-    const unsigned int chunk_x = grid_x / CHUNK_SIZE_IN_TILES.x;
-    const unsigned int chunk_y = grid_y / CHUNK_SIZE_IN_TILES.y;
+    bool removed = false;
 
-    const unsigned int tile_x = grid_x - (chunk_x * CHUNK_SIZE_IN_TILES.x);
-    const unsigned int tile_y = grid_y - (chunk_y * CHUNK_SIZE_IN_TILES.y);
+    chunks.edit(chunk_index, [&](Chunk &chunk) {
+        const int top_layer = chunk.getTopLayer(tile.x, tile.y);
+        if (top_layer < 0)
+            return;
 
-    if (!chunks[chunk_x][chunk_y])
-        return false;
+        chunk.removeTile(tile.x, tile.y, top_layer);
+        chunk.flags |= ChunkFlags::Modified;
+        removed = true;
+    });
 
-    if (chunks[chunk_x][chunk_y]->tiles[tile_x][tile_y].empty())
-        return false;
-
-    for (int i = chunks[chunk_x][chunk_y]->tiles[tile_x][tile_y].size() - 1; i >= 0; i--)
-    {
-        if (chunks[chunk_x][chunk_y]->tiles[tile_x][tile_y][i])
-        {
-            chunks[chunk_x][chunk_y]->tiles[tile_x][tile_y][i].reset();
-            chunks[chunk_x][chunk_y]->updateVertexArray();
-            return true;
-        }
-    }
+    if (removed)
+        queueMeshBuild(chunk_index);
 
-    return false;
+    return removed;
 }
 
 const sf::Vector2f Map::getSpawnPoint() const
@@ -602,33 +913,21 @@ const sf::Vector2f Map::getRealDimensions() const
 
 const BiomePreset Map::getBiomeAt(const sf::Vector2i &grid_pos) const
 {
-    if (grid_pos.x < 0 || grid_pos.y < 0 || grid_pos.x >= MAX_WORLD_GRID_SIZE.x || grid_pos.y >= MAX_WORLD_GRID_SIZE.y)
-        return BiomePreset{};
-
     return this->terrainGenerator->getBiomeData(grid_pos);
 }
 
 const float Map::getHeightAt(const sf::Vector2i &grid_pos) const
 {
-    if (grid_pos.x < 0 || grid_pos.y < 0 || grid_pos.x >= MAX_WORLD_GRID_SIZE.x || grid_pos.y >= MAX_WORLD_GRID_SIZE.y)
-        return 0.f;
-
     return terrainGenerator->getHeightAt(grid_pos);
 }
 
 const float Map::getMoistureAt(const sf::Vector2i &grid_pos) const
 {
-    if (grid_pos.x < 0 || grid_pos.y < 0 || grid_pos.x >= MAX_WORLD_GRID_SIZE.x || grid_pos.y >= MAX_WORLD_GRID_SIZE.y)
-        return 0.f;
-
     return terrainGenerator->getMoistureAt(grid_pos);
 }
 
 const float Map::getHeatAt(const sf::Vector2i &grid_pos) const
 {
-    if (grid_pos.x < 0 || grid_pos.y < 0 || grid_pos.x >= MAX_WORLD_GRID_SIZE.x || grid_pos.y >= MAX_WORLD_GRID_SIZE.y)
-        return 0.f;
-
     return terrainGenerator->getHeatAt(grid_pos);
 }
 
@@ -647,11 +946,38 @@ const std::string &Map::getFolderName() const
     return folderName;
 }
 
-const std::optional<bool> Map::isRegionLoaded(const sf::Vector2i &region_index)
+const bool Map::isRegionLoaded(const sf::Vector2i &region_index)
+{
+    return chunks.isRegionLoaded(region_index);
+}
+
+void Map::setMemoryBudget(const size_t bytes)
+{
+    memoryBudget = bytes;
+}
+
+const size_t Map::getMemoryBudget() const
+{
+    return memoryBudget;
+}
+
+void Map::setSaveMode(const RegionSaveMode mode)
+{
+    saveMode = mode;
+    metadata.saveMode = mode == RegionSaveMode::Delta ? "delta" : "full";
+}
+
+const RegionSaveMode Map::getSaveMode() const
 {
-    if (region_index.x < 0 || region_index.x >= MAX_REGIONS.x || region_index.y < 0 || region_index.y >= MAX_REGIONS.y)
-        logger.logWarning(_("Region (") + std::to_string(region_index.x) + ", " + std::to_string(region_index.y) +
-                          _(") out of bounds."));
+    return saveMode;
+}
 
-    return loadedRegions[region_index.x][region_index.y];
+const MapRenderStats &Map::getRenderStats() const
+{
+    return renderStats;
+}
+
+const ChunkCacheStats Map::getCacheStats() const
+{
+    return chunks.getStats();
 }
@@ -0,0 +1,717 @@
+#include "Map/RegionFile.hxx"
+#include "stdafx.hxx"
+
+std::mutex RegionFile::writeMutex;
+std::unordered_map<std::string, std::shared_future<bool>> RegionFile::pendingWrites;
+
+/* PRIVATE METHODS ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ */
+
+ThreadPool &RegionFile::getWritePool()
+{
+    static ThreadPool pool(REGION_WRITE_WORKERS, "Region writer");
+    return pool;
+}
+
+const bool RegionFile::readHeader(std::istream &file, SlotTable &table, const uint16_t version)
+{
+    char magic[sizeof(REGION_FILE_MAGIC)];
+    uint16_t file_version = 0, chunk_count = 0;
+
+    if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, REGION_FILE_MAGIC, sizeof(magic)) != 0)
+        return false;
+
+    if (!file.read(reinterpret_cast<char *>(&file_version), sizeof(uint16_t)) || file_version != version)
+        return false;
+
+    if (!file.read(reinterpret_cast<char *>(&chunk_count), sizeof(uint16_t)) || chunk_count != REGION_CHUNK_COUNT)
+        return false;
+
+    for (auto &slot : table)
+    {
+        if (!file.read(reinterpret_cast<char *>(&slot.offset), sizeof(uint32_t)) ||
+            !file.read(reinterpret_cast<char *>(&slot.length), sizeof(uint32_t)))
+            return false;
+
+        if (slot.length > 0 && slot.offset < HEADER_SIZE)
+            return false;
+    }
+
+    return true;
+}
+
+void RegionFile::writeHeader(std::ostream &file, const SlotTable &table)
+{
+    const uint16_t version = REGION_FILE_VERSION;
+    const uint16_t chunk_count = REGION_CHUNK_COUNT;
+
+    file.write(REGION_FILE_MAGIC, sizeof(REGION_FILE_MAGIC));
+    file.write(reinterpret_cast<const char *>(&version), sizeof(uint16_t));
+    file.write(reinterpret_cast<const char *>(&chunk_count), sizeof(uint16_t));
+
+    for (auto &slot : table)
+    {
+        file.write(reinterpret_cast<const char *>(&slot.offset), sizeof(uint32_t));
+        file.write(reinterpret_cast<const char *>(&slot.length), sizeof(uint32_t));
+    }
+}
+
+const bool RegionFile::encodeChunk(const ChunkRecord &record, std::vector<char> &bytes)
+{
+    const uint16_t palette_size = static_cast<uint16_t>(record.palette.size());
+
+    // Small palettes (the common case) fit every cell, empty and unchanged ones included, in a single byte.
+    const uint8_t cell_width = palette_size < 0xFE ? sizeof(uint8_t) : sizeof(uint16_t);
+    const uint8_t delta = record.delta ? 1 : 0;
+    const uint8_t status = static_cast<uint8_t>(record.status);
+
+    std::vector<uint8_t> narrow_cells;
+    const Bytef *cells = reinterpret_cast<const Bytef *>(record.cells.data());
+    const uLong cells_length = CHUNK_VOLUME * cell_width;
+
+    if (cell_width == sizeof(uint8_t))
+    {
+        narrow_cells.resize(CHUNK_VOLUME);
+
+        for (unsigned int i = 0; i < CHUNK_VOLUME; i++)
+        {
+            if (record.cells[i] == EMPTY_CELL)
+                narrow_cells[i] = 0xFF;
+            else if (record.cells[i] == UNCHANGED_CELL)
+                narrow_cells[i] = 0xFE;
+            else
+                narrow_cells[i] = static_cast<uint8_t>(record.cells[i]);
+        }
+
+        cells = narrow_cells.data();
+    }
+
+    uLongf compressed_size = compressBound(cells_length);
+    std::vector<Bytef> compressed(compressed_size);
+
+    if (compress2(compressed.data(), &compressed_size, cells, cells_length, Z_BEST_SPEED) != Z_OK)
+        return false;
+
+    const uint32_t cells_size = static_cast<uint32_t>(compressed_size);
+
+    bytes.clear();
+    bytes.reserve(3 * sizeof(uint8_t) + sizeof(uint16_t) + palette_size * sizeof(WorldTileId) +
+                  sizeof(uint8_t) + sizeof(uint32_t) + cells_size);
+
+    auto put = [&bytes](const void *data, const size_t size) {
+        bytes.insert(bytes.end(), static_cast<const char *>(data), static_cast<const char *>(data) + size);
+    };
+
+    put(&record.flags, sizeof(uint8_t));
+    put(&delta, sizeof(uint8_t));
+    put(&status, sizeof(uint8_t));
+    put(&palette_size, sizeof(uint16_t));
+    put(record.palette.data(), palette_size * sizeof(WorldTileId));
+    put(&cell_width, sizeof(uint8_t));
+    put(&cells_size, sizeof(uint32_t));
+    put(compressed.data(), cells_size);
+
+    return true;
+}
+
+const bool RegionFile::decodeChunk(const std::vector<char> &bytes, ChunkRecord &record, const uint16_t version)
+{
+    size_t cursor = 0;
+
+    auto get = [&bytes, &cursor](void *data, const size_t size) {
+        if (cursor + size > bytes.size())
+            return false;
+
+        std::memcpy(data, bytes.data() + cursor, size);
+        cursor += size;
+        return true;
+    };
+
+    uint16_t palette_size = 0;
+    uint8_t delta = 0, status = static_cast<uint8_t>(ChunkStatus::Complete), cell_width = 0;
+    uint32_t cells_size = 0;
+
+    if (!get(&record.flags, sizeof(uint8_t)))
+        return false;
+
+    // Version 3 has no delta records.
+    if (version >= 4 && !get(&delta, sizeof(uint8_t)))
+        return false;
+
+    record.delta = delta != 0;
+
+    // Versions 3 and 4 only hold complete chunks.
+    if (version >= 5 && (!get(&status, sizeof(uint8_t)) || status > static_cast<uint8_t>(ChunkStatus::Complete)))
+        return false;
+
+    record.status = static_cast<ChunkStatus>(status);
+
+    if (!get(&palette_size, sizeof(uint16_t)))
+        return false;
+
+    record.palette.resize(palette_size);
+
+    if (!get(record.palette.data(), palette_size * sizeof(WorldTileId)) || !get(&cell_width, sizeof(uint8_t)) ||
+        !get(&cells_size, sizeof(uint32_t)) || cursor + cells_size > bytes.size())
+        return false;
+
+    const Bytef *compressed = reinterpret_cast<const Bytef *>(bytes.data() + cursor);
+
+    if (cell_width == sizeof(uint16_t))
+    {
+        uLongf cells_length = sizeof(TileCells);
+
+        return uncompress(reinterpret_cast<Bytef *>(record.cells.data()), &cells_length, compressed, cells_size) ==
+                   Z_OK &&
+               cells_length == sizeof(TileCells);
+    }
+
+    if (cell_width != sizeof(uint8_t))
+        return false;
+
+    std::array<uint8_t, CHUNK_VOLUME> narrow_cells;
+    uLongf cells_length = CHUNK_VOLUME;
+
+    if (uncompress(narrow_cells.data(), &cells_length, compressed, cells_size) != Z_OK || cells_length != CHUNK_VOLUME)
+        return false;
+
+    for (unsigned int i = 0; i < CHUNK_VOLUME; i++)
+    {
+        if (narrow_cells[i] == 0xFF)
+            record.cells[i] = EMPTY_CELL;
+        else if (narrow_cells[i] == 0xFE && record.delta)
+            record.cells[i] = UNCHANGED_CELL;
+        else
+            record.cells[i] = narrow_cells[i];
+    }
+
+    return true;
+}
+
+const bool RegionFile::readLegacy(const std::filesystem::path &path, RegionRecords &records, HashedPalettes &hashes)
+{
+    Logger logger("RegionFile");
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+    {
+        logger.logError(_("Failed to open region file: ") + path.string(), false);
+        return false;
+    }
+
+    unsigned short chunk_x = 0, chunk_y = 0, tile_amount = 0;
+    uint8_t flags;
+
+    while (file.read(reinterpret_cast<char *>(&chunk_x), sizeof(unsigned short)) &&
+           file.read(reinterpret_cast<char *>(&chunk_y), sizeof(unsigned short)) &&
+           file.read(reinterpret_cast<char *>(&flags), sizeof(uint8_t)) &&
+           file.read(reinterpret_cast<char *>(&tile_amount), sizeof(unsigned short)))
+    {
+        const unsigned int slot = getSlot(sf::Vector2i(chunk_x, chunk_y));
+
+        ChunkRecord &record = records[slot].emplace();
+        record.flags = flags;
+        record.cells.fill(EMPTY_CELL);
+
+        std::vector<uint64_t> &palette = hashes[slot];
+        palette.clear();
+
+        for (int i = 0; i < tile_amount; i++)
+        {
+            unsigned short x = 0, y = 0, z = 0;
+            uint64_t hash;
+
+            if (!file.read(reinterpret_cast<char *>(&hash), sizeof(uint64_t)) ||
+                !file.read(reinterpret_cast<char *>(&x), sizeof(unsigned short)) ||
+                !file.read(reinterpret_cast<char *>(&y), sizeof(unsigned short)) ||
+                !file.read(reinterpret_cast<char *>(&z), sizeof(unsigned short)) || x >= CHUNK_SIZE_IN_TILES.x ||
+                y >= CHUNK_SIZE_IN_TILES.y || z >= CHUNK_SIZE_IN_TILES.z)
+            {
+                logger.logError(_("Corrupted legacy region file: ") + path.string(), false);
+                return false;
+            }
+
+            auto it = std::find(palette.begin(), palette.end(), hash);
+
+            if (it == palette.end())
+                it = palette.insert(palette.end(), hash);
+
+            record.cells[Chunk::cellIndex(x, y, z)] = static_cast<uint16_t>(it - palette.begin());
+        }
+    }
+
+    return true;
+}
+
+const bool RegionFile::readVersion2(const std::filesystem::path &path, RegionRecords &records,
+                                    HashedPalettes &hashes)
+{
+    Logger logger("RegionFile");
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+    {
+        logger.logError(_("Failed to open region file: ") + path.string(), false);
+        return false;
+    }
+
+    SlotTable table;
+    if (!readHeader(file, table, 2))
+    {
+        logger.logError(_("Invalid region file header: ") + path.string(), false);
+        return false;
+    }
+
+    for (unsigned int slot = 0; slot < REGION_CHUNK_COUNT; slot++)
+    {
+        records[slot].reset();
+
+        if (table[slot].length == 0)
+            continue;
+
+        ChunkRecord &record = records[slot].emplace();
+        uint16_t palette_size = 0;
+        uint32_t cells_size = 0;
+
+        // Version 2 chunks: flags, palette of 64-bit tile hashes, then the 16-bit cells compressed with zlib.
+        if (!file.seekg(table[slot].offset) || !file.read(reinterpret_cast<char *>(&record.flags), sizeof(uint8_t)) ||
+            !file.read(reinterpret_cast<char *>(&palette_size), sizeof(uint16_t)))
+            return false;
+
+        hashes[slot].resize(palette_size);
+
+        if (!file.read(reinterpret_cast<char *>(hashes[slot].data()), palette_size * sizeof(uint64_t)) ||
+            !file.read(reinterpret_cast<char *>(&cells_size), sizeof(uint32_t)))
+            return false;
+
+        std::vector<Bytef> compressed(cells_size);
+        uLongf cells_length = sizeof(TileCells);
+
+        if (!file.read(reinterpret_cast<char *>(compressed.data()), cells_size) ||
+            uncompress(reinterpret_cast<Bytef *>(record.cells.data()), &cells_length, compressed.data(),
+                       cells_size) != Z_OK ||
+            cells_length != sizeof(TileCells))
+        {
+            logger.logError(_("Corrupted chunk in region file: ") + path.string() + " [" + std::to_string(slot) + "]",
+                            false);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+const bool RegionFile::readRecords(const std::filesystem::path &path, RegionRecords &records, const uint16_t version)
+{
+    Logger logger("RegionFile");
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+    {
+        logger.logError(_("Failed to open region file: ") + path.string(), false);
+        return false;
+    }
+
+    SlotTable table;
+    if (!readHeader(file, table, version))
+    {
+        logger.logError(_("Invalid region file header: ") + path.string(), false);
+        return false;
+    }
+
+    std::vector<char> bytes;
+
+    for (unsigned int slot = 0; slot < REGION_CHUNK_COUNT; slot++)
+    {
+        records[slot].reset();
+
+        if (table[slot].length == 0)
+            continue;
+
+        bytes.resize(table[slot].length);
+
+        if (!file.seekg(table[slot].offset) || !file.read(bytes.data(), bytes.size()) ||
+            !decodeChunk(bytes, records[slot].emplace(), version))
+        {
+            logger.logError(_("Corrupted chunk in region file: ") + path.string() + " [" + std::to_string(slot) + "]",
+                            false);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* PUBLIC METHODS +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ */
+
+const unsigned int RegionFile::getSlot(const sf::Vector2i &chunk_index)
+{
+    const int REGION_WIDTH = static_cast<int>(REGION_SIZE_IN_CHUNKS.x);
+    const int REGION_HEIGHT = static_cast<int>(REGION_SIZE_IN_CHUNKS.y);
+
+    // Positive remainders, so the chunks of negative regions use the same slots as the others.
+    const int x = ((chunk_index.x % REGION_WIDTH) + REGION_WIDTH) % REGION_WIDTH;
+    const int y = ((chunk_index.y % REGION_HEIGHT) + REGION_HEIGHT) % REGION_HEIGHT;
+
+    return static_cast<unsigned int>(y * REGION_WIDTH + x);
+}
+
+const uint16_t RegionFile::getVersion(const std::filesystem::path &path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+        return 0;
+
+    char magic[sizeof(REGION_FILE_MAGIC)];
+
+    if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, REGION_FILE_MAGIC, sizeof(magic)) != 0)
+        return REGION_FILE_LEGACY_VERSION;
+
+    uint16_t version = 0;
+    file.read(reinterpret_cast<char *>(&version), sizeof(uint16_t));
+
+    return version;
+}
+
+const bool RegionFile::read(const std::filesystem::path &path, RegionRecords &records)
+{
+    PROFILE_SCOPE("RegionFile::read");
+
+    return readRecords(path, records, REGION_FILE_VERSION);
+}
+
+const bool RegionFile::readChunk(const std::filesystem::path &path, const unsigned int slot,
+                                 std::optional<ChunkRecord> &record)
+{
+    Logger logger("RegionFile");
+
+    record.reset();
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+    {
+        logger.logError(_("Failed to open region file: ") + path.string(), false);
+        return false;
+    }
+
+    SlotTable table;
+    if (!readHeader(file, table))
+    {
+        logger.logError(_("Invalid region file header: ") + path.string(), false);
+        return false;
+    }
+
+    if (table[slot].length == 0)
+        return true;
+
+    std::vector<char> bytes(table[slot].length);
+
+    if (!file.seekg(table[slot].offset) || !file.read(bytes.data(), bytes.size()) ||
+        !decodeChunk(bytes, record.emplace()))
+    {
+        record.reset();
+        logger.logError(_("Corrupted chunk in region file: ") + path.string() + " [" + std::to_string(slot) + "]",
+                        false);
+        return false;
+    }
+
+    return true;
+}
+
+const bool RegionFile::write(const std::filesystem::path &path, const RegionRecords &records)
+{
+    PROFILE_SCOPE("RegionFile::write");
+
+    Logger logger("RegionFile");
+
+    std::filesystem::path tmp_path = path;
+    tmp_path += ".tmp";
+
+    std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+    {
+        logger.logError(_("Failed to write region file: ") + tmp_path.string(), false);
+        return false;
+    }
+
+    SlotTable table = {};
+    std::vector<char> bytes;
+
+    // Reserve the header, then fill the table in as chunks are appended.
+    writeHeader(file, table);
+
+    uint32_t offset = HEADER_SIZE;
+
+    for (unsigned int slot = 0; slot < REGION_CHUNK_COUNT; slot++)
+    {
+        if (!records[slot].has_value())
+            continue;
+
+        if (!encodeChunk(records[slot].value(), bytes))
+        {
+            logger.logError(_("Failed to compress chunk for region file: ") + path.string(), false);
+            file.close();
+            std::filesystem::remove(tmp_path);
+            return false;
+        }
+
+        file.write(bytes.data(), bytes.size());
+
+        table[slot].offset = offset;
+        table[slot].length = static_cast<uint32_t>(bytes.size());
+        offset += table[slot].length;
+    }
+
+    file.seekp(0);
+    writeHeader(file, table);
+    file.close();
+
+    if (!file)
+    {
+        logger.logError(_("Failed to write region file: ") + tmp_path.string(), false);
+        return false;
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmp_path, path, ec);
+
+    if (ec)
+    {
+        logger.logError(_("Failed to replace region file: ") + path.string() + " (" + ec.message() + ")", false);
+        return false;
+    }
+
+    return true;
+}
+
+std::shared_future<bool> RegionFile::writeAsync(const std::filesystem::path &path, RegionRecords records,
+                                               std::function<void(RegionRecords &)> prepare)
+{
+    std::lock_guard<std::mutex> lock(writeMutex);
+
+    // Drop the bookkeeping of writes that are already done.
+    for (auto it = pendingWrites.begin(); it != pendingWrites.end();)
+    {
+        if (it->second.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+            it = pendingWrites.erase(it);
+        else
+            it++;
+    }
+
+    std::shared_future<bool> previous;
+
+    auto it = pendingWrites.find(path.string());
+    if (it != pendingWrites.end())
+        previous = it->second;
+
+    // The pool runs tasks in order, so a previous write of the same file has already started by the time this one
+    // waits for it.
+    std::shared_future<bool> future =
+        getWritePool()
+            .enqueue([path, records = std::move(records), prepare = std::move(prepare), previous]() mutable {
+                if (prepare)
+                    prepare(records);
+
+                if (previous.valid())
+                    previous.wait();
+
+                return write(path, records);
+            })
+            .share();
+
+    pendingWrites[path.string()] = future;
+    return future;
+}
+
+void RegionFile::waitForWrites(const std::filesystem::path &path)
+{
+    std::shared_future<bool> future;
+
+    {
+        std::lock_guard<std::mutex> lock(writeMutex);
+
+        auto it = pendingWrites.find(path.string());
+        if (it == pendingWrites.end())
+            return;
+
+        future = it->second;
+    }
+
+    future.wait();
+}
+
+void RegionFile::waitForWrites()
+{
+    std::vector<std::shared_future<bool>> futures;
+
+    {
+        std::lock_guard<std::mutex> lock(writeMutex);
+
+        for (auto &[path, future] : pendingWrites)
+            futures.push_back(future);
+    }
+
+    for (auto &future : futures)
+        future.wait();
+}
+
+const bool RegionFile::upgrade(const std::filesystem::path &path, RegionRecords &records, const TileDatabase &tile_db,
+                               TileIdTable &tile_ids)
+{
+    Logger logger("RegionFile");
+
+    HashedPalettes hashes;
+
+    const uint16_t version = getVersion(path);
+
+    if (version == REGION_FILE_VERSION)
+        return read(path, records);
+
+    // Versions 3 and 4 already use world IDs, only the chunk layout changed.
+    if (version == 3 || version == 4)
+        return readRecords(path, records, version);
+
+    if (version == REGION_FILE_LEGACY_VERSION)
+    {
+        if (!readLegacy(path, records, hashes))
+            return false;
+    }
+    else if (version == 2)
+    {
+        if (!readVersion2(path, records, hashes))
+            return false;
+    }
+    else
+    {
+        logger.logError(_("Unsupported region file version: ") + std::to_string(version) + " " + path.string(), false);
+        return false;
+    }
+
+    for (unsigned int slot = 0; slot < REGION_CHUNK_COUNT; slot++)
+    {
+        if (!records[slot].has_value())
+            continue;
+
+        for (const uint64_t &hash : hashes[slot])
+        {
+            const TileData &td = tile_db.getByHash(hash);
+
+            if (td.id == UNKNOWN_TILE_ID)
+                logger.logWarning(_("Invalid tile ID: ") + std::to_string(hash) + " " + path.string());
+
+            records[slot]->palette.push_back(tile_ids.getWorldId(td, tile_db));
+        }
+    }
+
+    return true;
+}
+
+ChunkRecord RegionFile::pack(const Chunk &chunk, const TileDatabase &tile_db, TileIdTable &tile_ids)
+{
+    ChunkRecord record;
+    record.flags = chunk.flags;
+    record.status = chunk.getStatus();
+
+    const std::vector<const TileData *> &palette = chunk.getPalette();
+    const TileCells &cells = chunk.getCells();
+
+    // Compact the palette, since the chunk may hold freed entries.
+    std::vector<uint16_t> remap(palette.size(), EMPTY_CELL);
+
+    for (size_t i = 0; i < palette.size(); i++)
+    {
+        if (!palette[i])
+            continue;
+
+        remap[i] = static_cast<uint16_t>(record.palette.size());
+        record.palette.push_back(tile_ids.getWorldId(*palette[i], tile_db));
+    }
+
+    for (unsigned int i = 0; i < CHUNK_VOLUME; i++)
+        record.cells[i] = cells[i] == EMPTY_CELL ? EMPTY_CELL : remap[cells[i]];
+
+    return record;
+}
+
+ChunkRecord RegionFile::packDelta(const ChunkSaveSnapshot &chunk, const Chunk &generated,
+                                  const TileDatabase &tile_db, TileIdTable &tile_ids)
+{
+    ChunkRecord record;
+    record.flags = chunk.flags;
+    record.delta = true;
+
+    const std::vector<const TileData *> &palette = chunk.palette;
+    const TileCells &cells = chunk.cells;
+
+    // Only the tile types of the changed cells make it into the palette.
+    std::vector<uint16_t> remap(palette.size(), EMPTY_CELL);
+
+    for (unsigned int i = 0; i < CHUNK_VOLUME; i++)
+    {
+        const unsigned int x = i % CHUNK_SIZE_IN_TILES.x;
+        const unsigned int y = (i / CHUNK_SIZE_IN_TILES.x) % CHUNK_SIZE_IN_TILES.y;
+        const unsigned int z = i / CHUNK_AREA;
+
+        const TileData *tile = cells[i] == EMPTY_CELL ? nullptr : palette[cells[i]];
+
+        if (tile == generated.getTileData(x, y, z))
+        {
+            record.cells[i] = UNCHANGED_CELL;
+            continue;
+        }
+
+        if (!tile)
+        {
+            record.cells[i] = EMPTY_CELL;
+            continue;
+        }
+
+        if (remap[cells[i]] == EMPTY_CELL)
+        {
+            remap[cells[i]] = static_cast<uint16_t>(record.palette.size());
+            record.palette.push_back(tile_ids.getWorldId(*tile, tile_db));
+        }
+
+        record.cells[i] = remap[cells[i]];
+    }
+
+    return record;
+}
+
+void RegionFile::unpack(const ChunkRecord &record, Chunk &chunk, const TileDatabase &tile_db,
+                        const TileIdTable &tile_ids)
+{
+    std::vector<const TileData *> palette;
+    palette.reserve(record.palette.size());
+
+    for (const WorldTileId &world_id : record.palette)
+        palette.push_back(&tile_ids.getTileData(world_id, tile_db));
+
+    chunk.flags = record.flags;
+
+    if (!record.delta)
+    {
+        chunk.assign(palette, record.cells);
+        return;
+    }
+
+    chunk.beginBatch();
+
+    for (unsigned int i = 0; i < CHUNK_VOLUME; i++)
+    {
+        const uint16_t cell = record.cells[i];
+
+        if (cell == UNCHANGED_CELL || (cell != EMPTY_CELL && cell >= palette.size()))
+            continue;
+
+        const unsigned int x = i % CHUNK_SIZE_IN_TILES.x;
+        const unsigned int y = (i / CHUNK_SIZE_IN_TILES.x) % CHUNK_SIZE_IN_TILES.y;
+        const unsigned int z = i / CHUNK_AREA;
+
+        chunk.removeTile(x, y, z);
+
+        if (cell != EMPTY_CELL)
+            chunk.putTile(*palette[cell], x, y, z);
+    }
+
+    chunk.endBatch();
+}
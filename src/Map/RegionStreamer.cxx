@@ -0,0 +1,121 @@
+#include "Map/RegionStreamer.hxx"
+#include "stdafx.hxx"
+
+/* PRIVATE METHODS ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ */
+
+void RegionStreamer::work()
+{
+    PROFILE_THREAD("Region streamer");
+
+    while (true)
+    {
+        RegionTask task;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+
+            auto next = queue.end();
+
+            condition.wait(lock, [&] {
+                if (!running)
+                    return true;
+
+                next = queue.end();
+                for (auto it = queue.begin(); it != queue.end(); it++)
+                {
+                    if (!isBusy(it->regionIndex) && (next == queue.end() || it->priority < next->priority))
+                        next = it;
+                }
+
+                return next != queue.end();
+            });
+
+            if (!running)
+                return;
+
+            task = *next;
+            queue.erase(next);
+            busy.push_back(task.regionIndex);
+        }
+
+        switch (task.type)
+        {
+        case RegionTaskType::Load: loadCallback(task.regionIndex); break;
+        case RegionTaskType::Decorate: decorateCallback(task.regionIndex); break;
+        case RegionTaskType::Unload: unloadCallback(task.regionIndex); break;
+        case RegionTaskType::Evict: evictCallback(task.regionIndex); break;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            busy.erase(std::find(busy.begin(), busy.end(), task.regionIndex));
+        }
+
+        // Requests for this region may have been waiting for it to be free.
+        condition.notify_all();
+    }
+}
+
+const bool RegionStreamer::isBusy(const sf::Vector2i &region_index) const
+{
+    return std::find(busy.begin(), busy.end(), region_index) != busy.end();
+}
+
+/* CONSTRUCTOR AND DESTRUCTOR +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ */
+
+RegionStreamer::RegionStreamer(std::function<void(const sf::Vector2i &)> load_callback,
+                               std::function<void(const sf::Vector2i &)> decorate_callback,
+                               std::function<void(const sf::Vector2i &)> unload_callback,
+                               std::function<void(const sf::Vector2i &)> evict_callback, unsigned int worker_count)
+    : loadCallback(std::move(load_callback)), decorateCallback(std::move(decorate_callback)),
+      unloadCallback(std::move(unload_callback)), evictCallback(std::move(evict_callback)), running(true)
+{
+    if (worker_count == 0)
+        worker_count = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+
+    for (unsigned int i = 0; i < worker_count; i++)
+        workers.emplace_back(&RegionStreamer::work, this);
+}
+
+RegionStreamer::~RegionStreamer()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+        queue.clear();
+    }
+
+    condition.notify_all();
+
+    for (auto &worker : workers)
+        worker.join();
+}
+
+/* PUBLIC METHODS +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ */
+
+void RegionStreamer::schedule(std::vector<RegionTask> tasks)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue = std::move(tasks);
+    }
+
+    condition.notify_all();
+}
+
+void RegionStreamer::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    queue.clear();
+}
+
+const bool RegionStreamer::isIdle()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return queue.empty() && busy.empty();
+}
+
+const size_t RegionStreamer::getWorkerCount() const
+{
+    return workers.size();
+}
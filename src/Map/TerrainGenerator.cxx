@@ -11,22 +11,10 @@ void TerrainGenerator::initPerlinWaves()
     heatWaves = {{318.6f, .06f, 8.f}};
 }
 
-void TerrainGenerator::initNoiseMaps()
-{
-    logger.logInfo(_("Generating noise maps..."));
-    msg = _("Generating noise maps...");
-
-    heightMap =
-        perlinNoise.generateNoiseMap(MAX_WORLD_GRID_SIZE.x, MAX_WORLD_GRID_SIZE.y, .06f, heightWaves, {0.f, 0.f});
-    moistureMap =
-        perlinNoise.generateNoiseMap(MAX_WORLD_GRID_SIZE.x, MAX_WORLD_GRID_SIZE.y, .009f, moistureWaves, {10.f, 10.f});
-    heatMap = perlinNoise.generateNoiseMap(MAX_WORLD_GRID_SIZE.x, MAX_WORLD_GRID_SIZE.y, .26f, heatWaves, {5.f, 5.f});
-}
-
 void TerrainGenerator::initBiomes()
 {
-    logger.logInfo(_("Precomputing biomes..."));
-    msg = _("Precomputing biomes...");
+    logger.logInfo(_("Initializing biomes..."));
+    msg = _("Initializing biomes...");
 
     biomes = {
         {BiomeType::Desert, .2f, .1f, .85f},     {BiomeType::Forest, .4f, .85f, .8f},
@@ -35,143 +23,230 @@ void TerrainGenerator::initBiomes()
         {BiomeType::Tundra, .65f, .4f, .1f},
     };
 
-    // sf::Image mapImg(sf::Vector2u(MAX_WORLD_GRID_SIZE.x / 4, MAX_WORLD_GRID_SIZE.y / 4));
+    biomePresets.resize(BIOME_TYPE_COUNT);
 
-    for (int x = 0; x < MAX_WORLD_GRID_SIZE.x; ++x)
+    // Tags are resolved here, once, so the generation stages only follow tile handles.
+    for (BiomeId id = 0; id < biomePresets.size(); id++)
     {
-        for (int y = 0; y < MAX_WORLD_GRID_SIZE.y; ++y)
+        const BiomeRule &rule = biomeRules.get(id);
+
+        BiomePreset &preset = biomePresets[id];
+        preset.type = static_cast<BiomeType>(id);
+
+        for (const auto &biome : biomes)
         {
-            float height = heightMap[x][y];
-            float moisture = moistureMap[x][y];
-            float heat = heatMap[x][y];
+            if (biome.getType() == preset.type)
+                preset.name = biome.getName();
+        }
+
+        preset.baseTileTag = rule.baseTileTag;
+        preset.baseTile = &tileDb.getByTag(preset.baseTileTag);
+        preset.color = computeTint(id, 0.f, 0.f);
+
+        decorations[id].clear();
+        float threshold = 0.f;
 
-            float maxWeight = -1.f;
-            for (const auto &biome : biomes)
+        for (const DecorationRule &decoration : rule.decorations)
+        {
+            if (decoration.z >= CHUNK_SIZE_IN_TILES.z || decoration.probability <= 0.f)
             {
-                float weight = biome.calculateWeight(height, moisture, heat);
-                if (weight > maxWeight)
-                {
-                    maxWeight = weight;
-                    biomeMap[x][y].name = biome.getName();
-                    biomeMap[x][y].type = biome.getType();
-                }
+                logger.logWarning(_("Ignoring invalid decoration ") + decoration.tileTag + _(" of biome ") +
+                                  preset.name);
+                continue;
             }
 
-            switch (biomeMap[x][y].type)
+            threshold += decoration.probability;
+            decorations[id].push_back({&tileDb.getByTag(decoration.tileTag), threshold, decoration.z});
+        }
+    }
+}
+
+std::shared_ptr<const ChunkClimate> TerrainGenerator::computeClimate(const sf::Vector2i &chunk_index) const
+{
+    auto climate = std::make_shared<ChunkClimate>();
+
+    const int GRID_START_X = chunk_index.x * static_cast<int>(CHUNK_SIZE_IN_TILES.x);
+    const int GRID_START_Y = chunk_index.y * static_cast<int>(CHUNK_SIZE_IN_TILES.y);
+
+    // Whole rows at a time, so the noise kernel can evaluate several columns per step.
+    for (unsigned int y = 0; y < CHUNK_SIZE_IN_TILES.y; ++y)
+    {
+        const float grid_x = static_cast<float>(GRID_START_X);
+        const float grid_y = static_cast<float>(GRID_START_Y + y);
+
+        perlinNoise.sampleRow(grid_x, grid_y, CHUNK_SIZE_IN_TILES.x, .06f, heightWaves, {0.f, 0.f},
+                              climate->heights.getRow(y));
+        perlinNoise.sampleRow(grid_x, grid_y, CHUNK_SIZE_IN_TILES.x, .009f, moistureWaves, {10.f, 10.f},
+                              climate->moistures.getRow(y));
+        perlinNoise.sampleRow(grid_x, grid_y, CHUNK_SIZE_IN_TILES.x, .26f, heatWaves, {5.f, 5.f},
+                              climate->heats.getRow(y));
+    }
+
+    const float *heights = climate->heights.getData();
+    const float *moistures = climate->moistures.getData();
+    const float *heats = climate->heats.getData();
+
+    for (unsigned int i = 0; i < CHUNK_AREA; ++i)
+    {
+        climate->biomes[i] = BiomeType::UnknownBiome;
+
+        float maxWeight = -1.f;
+        for (const auto &biome : biomes)
+        {
+            float weight = biome.calculateWeight(heights[i], moistures[i], heats[i]);
+            if (weight > maxWeight)
             {
-            case BiomeType::Desert:
-                biomeMap[x][y].color = sf::Color(194, 178, 128, 255);
-                biomeMap[x][y].baseTileTag = "pixelminer:sand_tile";
-                break;
-            case BiomeType::Forest:
-                biomeMap[x][y].color = sf::Color(24 * std::pow(3.f, (1.f - moisture + heat)), 110, 20, 255);
-                biomeMap[x][y].baseTileTag = "pixelminer:grass_tile";
-                break;
-            case BiomeType::Grassland:
-                biomeMap[x][y].color = sf::Color(26 * std::pow(3.2f, (1.f - moisture + heat)), 148, 24, 255);
-                biomeMap[x][y].baseTileTag = "pixelminer:grass_tile";
-                break;
-            case BiomeType::Jungle:
-                biomeMap[x][y].color = sf::Color(25 * std::pow(3.2f, (1.f - moisture + heat)), 130, 20, 255);
-                biomeMap[x][y].baseTileTag = "pixelminer:grass_tile";
-                break;
-            case BiomeType::Mountains:
-                biomeMap[x][y].color = sf::Color(150, 150, 150, 255);
-                biomeMap[x][y].baseTileTag = "pixelminer:stone_tile";
-                break;
-            case BiomeType::Ocean:
-                biomeMap[x][y].color = sf::Color(16, 51, 163, 255);
-                biomeMap[x][y].baseTileTag = "pixelminer:water_tile";
-                break;
-            case BiomeType::Tundra:
-                biomeMap[x][y].color = sf::Color(255, 255, 255, 255);
-                biomeMap[x][y].baseTileTag = "pixelminer:snowy_grass_tile";
-                break;
-            default:
-                biomeMap[x][y].color = sf::Color::White;
-                biomeMap[x][y].baseTileTag = "unknown";
-                break;
+                maxWeight = weight;
+                climate->biomes[i] = static_cast<BiomeId>(biome.getType());
             }
-
-            // mapImg.setPixel(sf::Vector2u(x / 4, y / 4), biomeMap[x][y].color);
         }
+
+        climate->tints[i] = computeTint(climate->biomes[i], moistures[i], heats[i]);
     }
 
-    // if (!mapImg.saveToFile(GLOBAL_FOLDER + "map.png"))
-    //     logger.logError(_("Failed to save map image."), false);
+    return climate;
 }
 
-void TerrainGenerator::initRandomGrid()
+std::shared_ptr<const ChunkClimate> TerrainGenerator::getClimate(const sf::Vector2i &chunk_index)
 {
-    randomGrid.resize(MAX_WORLD_GRID_SIZE.x, std::vector<float>(MAX_WORLD_GRID_SIZE.y, 0.0f));
+    // Both coordinates are kept whole, so no two chunks share a key, whatever their sign or distance.
+    const uint64_t key =
+        (static_cast<uint64_t>(static_cast<uint32_t>(chunk_index.x)) << 32) | static_cast<uint32_t>(chunk_index.y);
+
+    {
+        std::lock_guard<std::mutex> lock(climateMutex);
+
+        auto it = climateIndex.find(key);
+        if (it != climateIndex.end())
+        {
+            climateCache.splice(climateCache.begin(), climateCache, it->second);
+            return it->second->second;
+        }
+    }
+
+    // Computed without the lock, so workers generating different regions don't wait on each other.
+    std::shared_ptr<const ChunkClimate> climate = computeClimate(chunk_index);
 
-    for (unsigned int x = 0; x < MAX_WORLD_GRID_SIZE.x; ++x)
+    std::lock_guard<std::mutex> lock(climateMutex);
+
+    if (climateIndex.find(key) == climateIndex.end())
     {
-        for (unsigned int y = 0; y < MAX_WORLD_GRID_SIZE.y; ++y)
+        climateCache.emplace_front(key, climate);
+        climateIndex.emplace(key, climateCache.begin());
+
+        if (climateCache.size() > CLIMATE_CACHE_SIZE)
         {
-            // Generate a random value between 0 and 1 for each grid cell
-            randomGrid[x][y] = rng.nextFloat();
+            climateIndex.erase(climateCache.back().first);
+            climateCache.pop_back();
         }
     }
+
+    return climate;
 }
 
-void TerrainGenerator::putTile(Tile tile, const int &grid_x, const int &grid_y, const int &grid_z)
+const sf::Color TerrainGenerator::computeTint(const BiomeId &biome_id, const float &moisture, const float &heat) const
 {
-    if (grid_x < 0 || grid_x >= MAX_WORLD_GRID_SIZE.x || grid_y < 0 || grid_y >= MAX_WORLD_GRID_SIZE.y || grid_z < 0 ||
-        grid_z >= CHUNK_SIZE_IN_TILES.z)
-        return;
+    switch (biome_id)
+    {
+    case BiomeType::Desert: return sf::Color(194, 178, 128, 255);
+    case BiomeType::Forest: return sf::Color(24 * std::pow(3.f, (1.f - moisture + heat)), 110, 20, 255);
+    case BiomeType::Grassland: return sf::Color(26 * std::pow(3.2f, (1.f - moisture + heat)), 148, 24, 255);
+    case BiomeType::Jungle: return sf::Color(25 * std::pow(3.2f, (1.f - moisture + heat)), 130, 20, 255);
+    case BiomeType::Mountains: return sf::Color(150, 150, 150, 255);
+    case BiomeType::Ocean: return sf::Color(16, 51, 163, 255);
+    case BiomeType::Tundra: return sf::Color(255, 255, 255, 255);
+    default: return sf::Color::White;
+    }
+}
 
-    const unsigned int chunk_x = grid_x / CHUNK_SIZE_IN_TILES.x;
-    const unsigned int chunk_y = grid_y / CHUNK_SIZE_IN_TILES.y;
+const sf::Vector2i TerrainGenerator::getChunkIndex(const sf::Vector2i &grid_pos)
+{
+    const int CHUNK_WIDTH = static_cast<int>(CHUNK_SIZE_IN_TILES.x);
+    const int CHUNK_HEIGHT = static_cast<int>(CHUNK_SIZE_IN_TILES.y);
 
-    const unsigned int tile_x = grid_x - (chunk_x * CHUNK_SIZE_IN_TILES.x);
-    const unsigned int tile_y = grid_y - (chunk_y * CHUNK_SIZE_IN_TILES.y);
+    // Integer division rounds towards zero, which would fold the chunks at -1 and 0 together.
+    return sf::Vector2i(grid_pos.x >= 0 ? grid_pos.x / CHUNK_WIDTH : (grid_pos.x + 1) / CHUNK_WIDTH - 1,
+                        grid_pos.y >= 0 ? grid_pos.y / CHUNK_HEIGHT : (grid_pos.y + 1) / CHUNK_HEIGHT - 1);
+}
 
-    tile.setGridPosition(sf::Vector2u(grid_x, grid_y));
+const sf::Vector2u TerrainGenerator::getTileIndex(const sf::Vector2i &grid_pos)
+{
+    const int CHUNK_WIDTH = static_cast<int>(CHUNK_SIZE_IN_TILES.x);
+    const int CHUNK_HEIGHT = static_cast<int>(CHUNK_SIZE_IN_TILES.y);
 
-    if (!chunks[chunk_x][chunk_y])
-        chunks[chunk_x][chunk_y] =
-            std::make_unique<Chunk>(texturePack, sf::Vector2u(chunk_x, chunk_y), scale, ChunkFlags::None);
+    return sf::Vector2u(((grid_pos.x % CHUNK_WIDTH) + CHUNK_WIDTH) % CHUNK_WIDTH,
+                        ((grid_pos.y % CHUNK_HEIGHT) + CHUNK_HEIGHT) % CHUNK_HEIGHT);
+}
 
-    if (!chunks[chunk_x][chunk_y]->tiles[tile_x][tile_y][grid_z])
+void TerrainGenerator::generateSurface(Chunk &chunk, const ChunkClimate &climate)
+{
+    for (unsigned int y = 0; y < CHUNK_SIZE_IN_TILES.y; ++y)
     {
-        chunks[chunk_x][chunk_y]->tiles[tile_x][tile_y][grid_z] = std::make_unique<Tile>(tile);
-        chunks[chunk_x][chunk_y]->updateVertexArray();
+        for (unsigned int x = 0; x < CHUNK_SIZE_IN_TILES.x; ++x)
+        {
+            const unsigned int i = y * CHUNK_SIZE_IN_TILES.x + x;
+
+            if (chunk.putTile(*biomePresets[climate.biomes[i]].baseTile, x, y, 0))
+                chunk.setTint(x, y, climate.tints[i]);
+        }
     }
 }
 
-Tile *TerrainGenerator::getTile(const int &grid_x, const int &grid_y, const int &grid_z)
+void TerrainGenerator::generateDecorations(Chunk &chunk, const ChunkClimate &climate)
 {
-    if (grid_x < 0 || grid_y < 0 || grid_z < 0 || grid_x >= MAX_WORLD_GRID_SIZE.x || grid_y >= MAX_WORLD_GRID_SIZE.y ||
-        grid_z > CHUNK_SIZE_IN_TILES.z)
-        return nullptr;
+    const int GRID_START_X = chunk.chunkIndex.x * static_cast<int>(CHUNK_SIZE_IN_TILES.x);
+    const int GRID_START_Y = chunk.chunkIndex.y * static_cast<int>(CHUNK_SIZE_IN_TILES.y);
+
+    for (unsigned int y = 0; y < CHUNK_SIZE_IN_TILES.y; ++y)
+    {
+        std::array<float, CHUNK_SIZE_IN_TILES.x> random_values;
+        rng.fillRow(GRID_START_X, GRID_START_Y + y, CHUNK_SIZE_IN_TILES.x, DECORATION_RANDOM_CHANNEL,
+                    random_values.data());
+
+        for (unsigned int x = 0; x < CHUNK_SIZE_IN_TILES.x; ++x)
+        {
+            const float random_value = random_values[x];
+
+            // Decorations only ever touch their own column, so no neighbouring chunk is needed.
+            for (const Decoration &decoration : decorations[climate.biomes[y * CHUNK_SIZE_IN_TILES.x + x]])
+            {
+                if (random_value < decoration.threshold)
+                {
+                    chunk.putTile(*decoration.tile, x, y, decoration.z);
+                    break;
+                }
+            }
+        }
+    }
+}
 
-    const unsigned int chunk_x = grid_x / CHUNK_SIZE_IN_TILES.x;
-    const unsigned int chunk_y = grid_y / CHUNK_SIZE_IN_TILES.y;
+std::optional<Tile> TerrainGenerator::getTile(const int &grid_x, const int &grid_y, const int &grid_z)
+{
+    if (grid_z < 0 || grid_z >= CHUNK_SIZE_IN_TILES.z)
+        return std::nullopt;
 
-    const unsigned int tile_x = grid_x - (chunk_x * CHUNK_SIZE_IN_TILES.x);
-    const unsigned int tile_y = grid_y - (chunk_y * CHUNK_SIZE_IN_TILES.y);
+    const sf::Vector2i chunk_index = getChunkIndex({grid_x, grid_y});
+    const sf::Vector2u tile = getTileIndex({grid_x, grid_y});
 
-    if (!chunks[chunk_x][chunk_y])
-        return nullptr;
+    const ChunkStore::ReadGuard guard = chunks.read();
 
-    if (!chunks[chunk_x][chunk_y]->tiles[tile_x][tile_y][grid_z])
-        return nullptr;
+    Chunk *chunk = chunks.get(chunk_index);
+    if (!chunk)
+        return std::nullopt;
 
-    return chunks[chunk_x][chunk_y]->tiles[tile_x][tile_y][grid_z].get();
+    return chunk->getTile(tile.x, tile.y, grid_z);
 }
 
-TerrainGenerator::TerrainGenerator(std::string &msg, Metadata &metadata, ChunkMatrix &chunks, long int seed,
-                                   sf::Texture &texture_pack, TileDatabase &tile_db, const float &scale)
+TerrainGenerator::TerrainGenerator(std::string &msg, Metadata &metadata, ChunkStore &chunks, long int seed,
+                                   sf::Texture &texture_pack, TileDatabase &tile_db, const BiomeRules &biome_rules,
+                                   const float &scale)
     : logger("TerrainGenerator"), msg(msg), metadata(metadata), chunks(chunks), seed(seed), texturePack(texture_pack),
-      tileDb(tile_db), scale(scale), rng(seed), perlinNoise(seed)
+      tileDb(tile_db), biomeRules(biome_rules), scale(scale), rng(seed), perlinNoise(seed)
 {
     using namespace std::chrono_literals;
 
     initPerlinWaves();
-    initNoiseMaps();
     initBiomes();
-    initRandomGrid();
 
     msg = _("Done!");
     std::this_thread::sleep_for(200ms);
@@ -179,80 +254,179 @@ TerrainGenerator::TerrainGenerator(std::string &msg, Metadata &metadata, ChunkMa
 
 TerrainGenerator::~TerrainGenerator() = default;
 
-void TerrainGenerator::generateRegion(const sf::Vector2i &region_index)
+void TerrainGenerator::generateRegion(const sf::Vector2i &region_index, const ChunkStatus target)
 {
-    if (region_index.x > MAX_REGIONS.x - 1 || region_index.y > MAX_REGIONS.y - 1 || region_index.x < 0 ||
-        region_index.y < 0)
+    PROFILE_SCOPE("TerrainGenerator::generateRegion");
+
+    const int CHUNK_START_X = region_index.x * static_cast<int>(REGION_SIZE_IN_CHUNKS.x);
+    const int CHUNK_START_Y = region_index.y * static_cast<int>(REGION_SIZE_IN_CHUNKS.y);
+
+    std::vector<sf::Vector2i> pending;
+
+    for (int c_x = CHUNK_START_X; c_x < CHUNK_START_X + static_cast<int>(REGION_SIZE_IN_CHUNKS.x); c_x++)
     {
-        logger.logError(_("Failed to generate region: Indexes are out of bounds."), false);
-        return;
+        for (int c_y = CHUNK_START_Y; c_y < CHUNK_START_Y + static_cast<int>(REGION_SIZE_IN_CHUNKS.y); c_y++)
+            pending.emplace_back(c_x, c_y);
     }
 
-    const int REGION_GRID_START_X = region_index.x * REGION_SIZE_IN_CHUNKS.x * CHUNK_SIZE_IN_TILES.x;
-    const int REGION_GRID_START_Y = region_index.y * REGION_SIZE_IN_CHUNKS.y * CHUNK_SIZE_IN_TILES.y;
-    const int REGION_GRID_END_X = (REGION_GRID_START_X + REGION_SIZE_IN_CHUNKS.x * CHUNK_SIZE_IN_TILES.x) - 1;
-    const int REGION_GRID_END_Y = (REGION_GRID_START_Y + REGION_SIZE_IN_CHUNKS.y * CHUNK_SIZE_IN_TILES.y) - 1;
-
-    for (int x = REGION_GRID_START_X; x <= REGION_GRID_END_X; ++x)
+    // Stages run on copies that are only stored once finished, so readers never find a chunk half-way. A chunk that
+    // was edited meanwhile keeps the edit: its copy is dropped, and the edited chunk goes through the stages again.
+    while (!pending.empty())
     {
-        for (int y = REGION_GRID_START_Y; y <= REGION_GRID_END_Y; ++y)
+        std::vector<sf::Vector2i> indexes;
+        std::vector<std::unique_ptr<Chunk>> region_chunks;
+        std::vector<std::optional<uint64_t>> revisions;
+        std::vector<bool> clean;
+
+        for (const sf::Vector2i &chunk_index : pending)
         {
-            const BiomePreset &biome = biomeMap[x][y];
-            TileData tile_data = tileDb.getByTag(biome.baseTileTag);
+            {
+                const ChunkStore::ReadGuard guard = chunks.read();
 
-            putTile(Tile(tile_data.name, tile_data.tag, tile_data.id, texturePack, tile_data.rect, scale, biome.color),
-                    x, y, 0);
+                const Chunk *resident = chunks.get(chunk_index);
+                if (resident && resident->getStatus() >= target)
+                    continue;
+            }
 
-            if (tile_data.tag == "pixelminer:grass_tile")
-            {
-                float randomValue = randomGrid[x][y];
+            uint64_t revision = 0;
+            std::unique_ptr<Chunk> chunk = chunks.clone(chunk_index, revision);
 
-                if (randomValue < 0.005f)
-                {
-                    TileData td = tileDb.getByTag("pixelminer:short_grass");
-                    putTile(Tile(td.name, td.tag, td.id, texturePack, td.rect, scale, biome.color), x, y, 1);
-                }
-                if (randomValue < 0.002f)
-                {
-                    TileData td = tileDb.getByTag("pixelminer:arbust_1");
-                    putTile(Tile(td.name, td.tag, td.id, texturePack, td.rect, scale, biome.color), x, y, 1);
-                }
-                if (randomValue < 0.001f)
-                {
-                    TileData td = tileDb.getByTag("pixelminer:arbust_2");
-                    putTile(Tile(td.name, td.tag, td.id, texturePack, td.rect, scale, biome.color), x, y, 1);
-                }
+            if (chunk)
+                revisions.push_back(revision);
+            else
+            {
+                chunk = std::make_unique<Chunk>(texturePack, chunk_index, scale, ChunkFlags::None);
+                revisions.push_back(std::nullopt);
             }
-            else if (tile_data.tag == "pixelminer:snowy_grass_tile")
+
+            // Batch every chunk of the region, so each mesh is updated once after all stages ran.
+            chunk->beginBatch();
+
+            clean.push_back(!chunk->hasUnsavedChanges());
+            indexes.push_back(chunk_index);
+            region_chunks.push_back(std::move(chunk));
+        }
+
+        std::vector<std::shared_ptr<const ChunkClimate>> climates(region_chunks.size());
+
+        for (const ChunkStatus stage : {ChunkStatus::Climate, ChunkStatus::Surface, ChunkStatus::Decorated})
+        {
+            if (stage > target)
+                break;
+
+            for (size_t i = 0; i < region_chunks.size(); i++)
             {
-                float randomValue = randomGrid[x][y];
+                Chunk &chunk = *region_chunks[i];
 
-                if (randomValue < 0.01f)
-                {
-                    TileData td = tileDb.getByTag("pixelminer:snow_tile");
-                    putTile(Tile(td.name, td.tag, td.id, texturePack, td.rect, scale, biome.color), x, y, 1);
-                }
+                if (chunk.getStatus() >= stage)
+                    continue;
+
+                if (!climates[i])
+                    climates[i] = getClimate(chunk.chunkIndex);
+
+                if (stage == ChunkStatus::Surface)
+                    generateSurface(chunk, *climates[i]);
+                else if (stage == ChunkStatus::Decorated)
+                    generateDecorations(chunk, *climates[i]);
+
+                chunk.setStatus(stage);
             }
         }
+
+        pending.clear();
+
+        for (size_t i = 0; i < region_chunks.size(); i++)
+        {
+            Chunk &chunk = *region_chunks[i];
+            chunk.endBatch();
+
+            if (target == ChunkStatus::Complete && chunk.getStatus() == ChunkStatus::Decorated)
+                chunk.setStatus(ChunkStatus::Complete);
+
+            // Generated terrain can always be generated again, so it only needs saving if the player changed
+            // something.
+            if (clean[i])
+                chunk.markSaved(chunk.getEpoch());
+
+            const bool stored = revisions[i].has_value()
+                                    ? chunks.replace(indexes[i], std::move(region_chunks[i]), revisions[i].value())
+                                    : chunks.insert(indexes[i], std::move(region_chunks[i]));
+
+            if (!stored)
+                pending.push_back(indexes[i]);
+        }
+    }
+}
+
+void TerrainGenerator::generateRegions(const std::vector<sf::Vector2i> &region_indexes, const ChunkStatus target,
+                                       const unsigned int thread_count)
+{
+    if (region_indexes.empty())
+        return;
+
+    logger.logInfo(_("Generating ") + std::to_string(region_indexes.size()) + _(" regions..."));
+    msg = _("Generating terrain...");
+
+    ThreadPool pool(thread_count > 0 ? thread_count : std::max(std::thread::hardware_concurrency(), 1u),
+                    "Terrain generator");
+
+    std::vector<std::future<void>> futures;
+    futures.reserve(region_indexes.size());
+
+    for (const sf::Vector2i &region_index : region_indexes)
+        futures.push_back(pool.enqueue([this, region_index, target]() { generateRegion(region_index, target); }));
+
+    for (size_t i = 0; i < futures.size(); i++)
+    {
+        futures[i].get();
+        msg = _("Generating terrain: ") + std::to_string((i + 1) * 100 / futures.size()) + "%";
     }
 }
 
-const BiomePreset &TerrainGenerator::getBiomeData(const sf::Vector2i &grid_pos) const
+std::unique_ptr<Chunk> TerrainGenerator::generateChunk(const sf::Vector2i &chunk_index)
+{
+    PROFILE_SCOPE("TerrainGenerator::generateChunk");
+
+    auto chunk = std::make_unique<Chunk>(texturePack, chunk_index, scale, ChunkFlags::None);
+    std::shared_ptr<const ChunkClimate> climate = getClimate(chunk_index);
+
+    // The batch is never closed: the chunk is only ever read, so building its mesh would be wasted work.
+    chunk->beginBatch();
+
+    generateSurface(*chunk, *climate);
+    generateDecorations(*chunk, *climate);
+    chunk->setStatus(ChunkStatus::Complete);
+
+    return chunk;
+}
+
+const BiomePreset TerrainGenerator::getBiomeData(const sf::Vector2i &grid_pos)
 {
-    return biomeMap[grid_pos.x][grid_pos.y];
+    std::shared_ptr<const ChunkClimate> climate = getClimate(getChunkIndex(grid_pos));
+    const sf::Vector2u tile = getTileIndex(grid_pos);
+
+    const unsigned int i = tile.y * CHUNK_SIZE_IN_TILES.x + tile.x;
+
+    BiomePreset preset = biomePresets[climate->biomes[i]];
+    preset.color = climate->tints[i];
+
+    return preset;
 }
 
-const float &TerrainGenerator::getHeightAt(const sf::Vector2i &grid_pos) const
+const float TerrainGenerator::getHeightAt(const sf::Vector2i &grid_pos)
 {
-    return heightMap[grid_pos.x][grid_pos.y];
+    const sf::Vector2u tile = getTileIndex(grid_pos);
+    return getClimate(getChunkIndex(grid_pos))->heights(tile.x, tile.y);
 }
 
-const float &TerrainGenerator::getMoistureAt(const sf::Vector2i &grid_pos) const
+const float TerrainGenerator::getMoistureAt(const sf::Vector2i &grid_pos)
 {
-    return moistureMap[grid_pos.x][grid_pos.y];
+    const sf::Vector2u tile = getTileIndex(grid_pos);
+    return getClimate(getChunkIndex(grid_pos))->moistures(tile.x, tile.y);
 }
 
-const float &TerrainGenerator::getHeatAt(const sf::Vector2i &grid_pos) const
+const float TerrainGenerator::getHeatAt(const sf::Vector2i &grid_pos)
 {
-    return heatMap[grid_pos.x][grid_pos.y];
+    const sf::Vector2u tile = getTileIndex(grid_pos);
+    return getClimate(getChunkIndex(grid_pos))->heats(tile.x, tile.y);
 }
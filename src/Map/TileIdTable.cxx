@@ -0,0 +1,151 @@
+#include "Map/TileIdTable.hxx"
+#include "stdafx.hxx"
+
+/* PRIVATE METHODS ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ */
+
+const WorldTileId TileIdTable::append(const std::string &tag, const TileDatabase &tile_db)
+{
+    const WorldTileId world_id = static_cast<WorldTileId>(tags.size());
+    const TileId runtime_id = tile_db.getIdByTag(tag);
+
+    tags.push_back(tag);
+    worldIds.emplace(tag, world_id);
+    runtimeIds.push_back(runtime_id);
+
+    if (runtime_id != UNKNOWN_TILE_ID || tag == "unknown")
+    {
+        if (worldIdsByRuntimeId.size() <= runtime_id)
+            worldIdsByRuntimeId.resize(runtime_id + 1, std::numeric_limits<WorldTileId>::max());
+
+        worldIdsByRuntimeId[runtime_id] = world_id;
+    }
+
+    modified = true;
+    return world_id;
+}
+
+/* CONSTRUCTOR AND DESTRUCTOR +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ */
+
+TileIdTable::TileIdTable() : logger("TileIdTable"), modified(false)
+{
+    tags.push_back("unknown");
+    worldIds.emplace("unknown", 0);
+    runtimeIds.push_back(UNKNOWN_TILE_ID);
+    worldIdsByRuntimeId.push_back(0);
+}
+
+TileIdTable::~TileIdTable() = default;
+
+/* PUBLIC METHODS +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ */
+
+const bool TileIdTable::load(const std::filesystem::path &path, const TileDatabase &tile_db)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    JArray tiles;
+
+    try
+    {
+        JObject obj = JSON::parse(path).getAs<JObject>();
+
+        if (obj.at("version").getAs<long long>() != TILE_ID_TABLE_VERSION)
+        {
+            logger.logError(_("Unsupported tile ID table version: ") + path.string(), false);
+            return false;
+        }
+
+        tiles = obj.at("tiles").getAs<JArray>();
+    }
+    catch (std::exception &e)
+    {
+        logger.logError(_("Failed to read tile ID table: ") + path.string() + " (" + e.what() + ")", false);
+        return false;
+    }
+
+    if (tiles.empty() || !tiles[0].isString() || tiles[0].getAs<std::string>() != "unknown")
+    {
+        logger.logError(_("Invalid tile ID table: ") + path.string(), false);
+        return false;
+    }
+
+    tags.clear();
+    worldIds.clear();
+    runtimeIds.clear();
+    worldIdsByRuntimeId.clear();
+
+    for (auto &tile : tiles)
+    {
+        const std::string tag = tile.isString() ? tile.getAs<std::string>() : "unknown";
+
+        if (tile_db.getIdByTag(tag) == UNKNOWN_TILE_ID && tag != "unknown")
+            logger.logWarning(_("Tile type not found in the active resource pack: ") + tag);
+
+        append(tag, tile_db);
+    }
+
+    modified = false;
+    return true;
+}
+
+const bool TileIdTable::save(const std::filesystem::path &path)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    JObject obj{{"version", TILE_ID_TABLE_VERSION}, {"tiles", JArray(tags.begin(), tags.end())}};
+
+    std::filesystem::path tmp_path = path;
+    tmp_path += ".tmp";
+
+    std::ofstream file(tmp_path);
+    if (!file.is_open())
+    {
+        logger.logError(_("Could not write tile ID table: ") + path.string(), false);
+        return false;
+    }
+
+    file << JSON::stringify(obj);
+    file.close();
+
+    std::error_code ec;
+    std::filesystem::rename(tmp_path, path, ec);
+
+    if (ec)
+    {
+        logger.logError(_("Could not write tile ID table: ") + path.string() + " (" + ec.message() + ")", false);
+        return false;
+    }
+
+    modified = false;
+    return true;
+}
+
+const WorldTileId TileIdTable::getWorldId(const TileData &data, const TileDatabase &tile_db)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (data.id < worldIdsByRuntimeId.size() &&
+        worldIdsByRuntimeId[data.id] != std::numeric_limits<WorldTileId>::max())
+        return worldIdsByRuntimeId[data.id];
+
+    auto it = worldIds.find(data.tag);
+    if (it != worldIds.end())
+        return it->second;
+
+    return append(data.tag, tile_db);
+}
+
+const TileData &TileIdTable::getTileData(const WorldTileId &world_id, const TileDatabase &tile_db) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (world_id >= runtimeIds.size())
+        return tile_db.getById(UNKNOWN_TILE_ID);
+
+    return tile_db.getById(runtimeIds[world_id]);
+}
+
+const bool TileIdTable::isModified() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return modified;
+}
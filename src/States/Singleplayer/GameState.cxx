@@ -33,14 +33,20 @@ void GameState::initLoadingScreen()
 
 void GameState::initMap()
 {
-    ctx.map = std::make_unique<Map>(data.activeResourcePack->tileDb, data.activeResourcePack->getTexture("TileSheet"),
-                                    *data.scale);
+    ctx.map = std::make_unique<Map>(data.activeResourcePack->tileDb, data.activeResourcePack->biomeRules,
+                                    data.activeResourcePack->getTexture("TileSheet"), *data.scale);
+
+    const unsigned int budget = std::clamp(data.gfx->memoryBudget, MIN_CHUNK_MEMORY_BUDGET, MAX_CHUNK_MEMORY_BUDGET);
+    ctx.map->setMemoryBudget(static_cast<size_t>(budget) * 1024 * 1024);
 }
 
 void GameState::initMap(const std::string &map_folder_name)
 {
-    ctx.map = std::make_unique<Map>(data.activeResourcePack->tileDb, data.activeResourcePack->getTexture("TileSheet"),
-                                    *data.scale);
+    ctx.map = std::make_unique<Map>(data.activeResourcePack->tileDb, data.activeResourcePack->biomeRules,
+                                    data.activeResourcePack->getTexture("TileSheet"), *data.scale);
+
+    const unsigned int budget = std::clamp(data.gfx->memoryBudget, MIN_CHUNK_MEMORY_BUDGET, MAX_CHUNK_MEMORY_BUDGET);
+    ctx.map->setMemoryBudget(static_cast<size_t>(budget) * 1024 * 1024);
     if (!map_folder_name.empty())
         ctx.map->load(map_folder_name);
 }
@@ -122,6 +128,8 @@ void GameState::resolveCollision(std::shared_ptr<Entity> &first_entity, std::sha
 
 void GameState::handleTileMining()
 {
+    PROFILE_SCOPE("GameState::handleTileMining");
+
     if (playerGUI->hasTileHovered())
     {
         if (sf::Mouse::isButtonPressed(sf::Mouse::Button::Left))
@@ -174,6 +182,27 @@ void GameState::handleTileMining()
     }
 }
 
+void GameState::exportProfilerTrace()
+{
+#ifdef PROFILER
+    const std::filesystem::path path =
+        std::filesystem::path(TRACES_FOLDER) / ("trace_" + std::to_string(std::time(nullptr)) + ".json");
+
+    try
+    {
+        std::filesystem::create_directories(path.parent_path());
+        const size_t zone_count = Profiler::exportTrace(path);
+        chat->displayGameLog(_("Exported ") + std::to_string(zone_count) + _(" profiler zones to ") + path.string());
+    }
+    catch (std::exception &e)
+    {
+        chat->displayGameLog(_("Failed to export the profiler trace: ") + e.what());
+    }
+#else
+    chat->displayGameLog(_("The profiler is disabled in this build."));
+#endif
+}
+
 GameState::GameState(EngineData &data) : State(data), server(data.uuid)
 {
     ctx.currentState = this;
@@ -214,6 +243,8 @@ GameState::~GameState() = default;
 
 void GameState::update(const float &dt)
 {
+    PROFILE_SCOPE("GameState::update");
+
     if (!ctx.map->isReady())
     {
         std::string msg = ctx.map->getMessage();
@@ -240,9 +271,6 @@ void GameState::update(const float &dt)
     }
 
     updateMap(dt);
-    updateGlobalEntities(dt);
-    updatePlayers(dt);
-    updateCollisions(dt);
     updatePlayerCamera();
     updateChat(dt);
     updateEntityRenderPriorityQueue();
@@ -263,11 +291,29 @@ void GameState::update(const float &dt)
             debugChunks = !debugChunks;
         else if (keyPressedWithin(250, sf::Keyboard::Key::F2))
             debugHitBoxes = !debugHitBoxes;
+        else if (keyPressedWithin(250, sf::Keyboard::Key::F4))
+            exportProfilerTrace();
     }
     else if (keyPressedWithin(250, sf::Keyboard::Key::F3))
         debugInfo = !debugInfo;
 }
 
+void GameState::fixedUpdate(const float &dt)
+{
+    PROFILE_SCOPE("GameState::fixedUpdate");
+
+    if (!ctx.map->isReady() || pauseMenu->isActive())
+        return;
+
+    for (auto &entity : ctx.globalEntities)
+        if (entity)
+            entity->storePreviousPosition();
+
+    updateGlobalEntities(dt);
+    updatePlayers(dt);
+    updateCollisions(dt);
+}
+
 void GameState::updatePauseMenu(const float &dt)
 {
     if (keyPressedWithin(250, sf::Keyboard::Key::Escape))
@@ -277,11 +323,15 @@ void GameState::updatePauseMenu(const float &dt)
 
 void GameState::updateMap(const float &dt)
 {
+    PROFILE_SCOPE("GameState::updateMap");
+
     ctx.map->update(dt, sf::Vector2i(thisPlayer->getCenterGridPosition()));
 }
 
 void GameState::updateGlobalEntities(const float &dt)
 {
+    PROFILE_SCOPE("GameState::updateGlobalEntities");
+
     for (auto &entity : ctx.globalEntities)
     {
         if (entity && entity->getType() != EntityType::PlayerEntity)
@@ -291,11 +341,13 @@ void GameState::updateGlobalEntities(const float &dt)
 
 void GameState::updatePlayers(const float &dt)
 {
+    PROFILE_SCOPE("GameState::updatePlayers");
+
     for (auto &[_, player] : ctx.players)
     {
         sf::Vector2f pos = player->getBottomGridPosition();
 
-        Tile *tile = ctx.map->getTile(pos.x, pos.y);
+        std::optional<Tile> tile = ctx.map->getTile(pos.x, pos.y);
         std::string tile_name_under = "Unknown";
 
         if (tile)
@@ -307,6 +359,8 @@ void GameState::updatePlayers(const float &dt)
 
 void GameState::updateEntityRenderPriorityQueue()
 {
+    PROFILE_SCOPE("GameState::updateEntityRenderPriorityQueue");
+
     for (auto &entity : ctx.globalEntities)
         if (entity)
             entityRenderPriorityQueue.push(entity);
@@ -314,6 +368,8 @@ void GameState::updateEntityRenderPriorityQueue()
 
 void GameState::updateCollisions(const float &dt)
 {
+    PROFILE_SCOPE("GameState::updateCollisions");
+
     // Get current and previous cell coordinates of the player
     const sf::Vector2i prev_cell_coords = entitySpacialGridPartition->getEntityCellGridCoords(thisPlayer);
     const sf::Vector2i curr_cell_coords = entitySpacialGridPartition->calcEntityCellGridCoords(thisPlayer);
@@ -387,7 +443,7 @@ void GameState::updateCollisions(const float &dt)
 
 void GameState::updatePlayerCamera()
 {
-    playerCamera.setCenter(thisPlayer->getCenter());
+    playerCamera.setCenter(thisPlayer->getInterpolatedPosition(data.interpolation) + thisPlayer->getSize() / 2.f);
     sf::Vector2f cameraCenter = playerCamera.getCenter();
     sf::Vector2f cameraSize = playerCamera.getSize();
     sf::Vector2f mapDimensions = ctx.map->getRealDimensions();
@@ -407,6 +463,8 @@ void GameState::updatePlayerCamera()
 
 void GameState::updateChat(const float &dt)
 {
+    PROFILE_SCOPE("GameState::updateChat");
+
     if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::LControl) && keyPressedWithin(250, sf::Keyboard::Key::C))
         chat->setActive(!chat->isActive());
     else if (keyPressedWithin(250, sf::Keyboard::Key::Enter) && chat->isActive())
@@ -432,13 +490,16 @@ void GameState::updateChat(const float &dt)
 
 void GameState::updateDebugText(const float &dt)
 {
+    PROFILE_SCOPE("GameState::updateDebugText");
+
     std::stringstream ss;
     ss << static_cast<int>(1.f / dt) << " fps\n"
        << std::fixed << std::setprecision(5) << dt << " ms\n"
        << _("grid x, y: ") << thisPlayer->getCenterGridPosition().x << " | " << thisPlayer->getCenterGridPosition().y
        << "\n"
-       << _("velocity x, y: ") << std::round(thisPlayer->getVelocity().x / *data.scale / dt) << " | "
-       << std::round(thisPlayer->getVelocity().y / *data.scale / dt) << "\n"
+       << static_cast<int>(std::round(1.f / data.tickDt)) << " tps\n"
+       << _("velocity x, y: ") << std::round(thisPlayer->getVelocity().x / *data.scale / data.tickDt) << " | "
+       << std::round(thisPlayer->getVelocity().y / *data.scale / data.tickDt) << "\n"
        << _("chunk:") << " ["
        << static_cast<unsigned int>(thisPlayer->getCenter().x / (CHUNK_SIZE_IN_TILES.x * data.gridSize * *data.scale))
        << ", "
@@ -456,12 +517,22 @@ void GameState::updateDebugText(const float &dt)
        << ctx.map->getMoistureAt(sf::Vector2i(thisPlayer->getCenterGridPosition())) << _(", heat: ")
        << ctx.map->getHeatAt(sf::Vector2i(thisPlayer->getCenterGridPosition())) << "\n";
 
+    const ChunkCacheStats cache = ctx.map->getCacheStats();
+    ss << _("chunks: ") << cache.chunkCount << " (" << cache.memoryUsage / (1024 * 1024) << " / "
+       << ctx.map->getMemoryBudget() / (1024 * 1024) << " MiB)\n"
+       << _("chunk hits, misses, evictions: ") << cache.hits << " | " << cache.misses << " | " << cache.evictions
+       << "\n"
+       << _("drawn chunks: ") << ctx.map->getRenderStats().drawnChunks << _(", vertices: ")
+       << ctx.map->getRenderStats().vertexCount << "\n";
+
     std::string str = ss.str();
     debugText->setString(sf::String::fromUtf8(str.begin(), str.end()));
 }
 
 void GameState::render(sf::RenderTarget &target)
 {
+    PROFILE_SCOPE("GameState::render");
+
     // DO NOT RENDER DIRECTLY TO TARGET!
 
     renderTexture.clear();
@@ -476,7 +547,7 @@ void GameState::render(sf::RenderTarget &target)
     }
 
     renderTexture.setView(playerCamera);
-    ctx.map->render(renderTexture, sf::Vector2i(thisPlayer->getCenterGridPosition()), debugChunks);
+    ctx.map->render(renderTexture, playerCamera, debugChunks);
 
     if (!chat->isActive())
         playerGUI->renderTileHoverIndicator(renderTexture);
@@ -502,15 +573,19 @@ void GameState::render(sf::RenderTarget &target)
 
 void GameState::renderGlobalEntities(sf::RenderTarget &target)
 {
+    PROFILE_SCOPE("GameState::renderGlobalEntities");
+
     while (!entityRenderPriorityQueue.empty())
     {
-        entityRenderPriorityQueue.top()->render(target, debugHitBoxes);
+        entityRenderPriorityQueue.top()->renderInterpolated(target, debugHitBoxes, data.interpolation);
         entityRenderPriorityQueue.pop();
     }
 }
 
 void GameState::saveWorld()
 {
+    PROFILE_SCOPE("GameState::saveWorld");
+
     ctx.map->save();
     for (auto &[uuid, player] : ctx.players)
         player->save(ctx.map->getFolderName(), uuid);
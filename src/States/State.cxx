@@ -14,6 +14,9 @@ State::~State() = default;
 void State::update(const float &dt)
 {}
 
+void State::fixedUpdate(const float &dt)
+{}
+
 void State::render(sf::RenderTarget &target)
 {}
 
@@ -1,78 +1,87 @@
 #include "Tiles/TileBase.hxx"
 #include "stdafx.hxx"
 
-TileBase::TileBase(const std::string &name, const std::string &tag, const uint64_t &id, sf::Texture &texture,
-                   const sf::IntRect &texture_rect, const sf::Vector2i &grid_position, const float &scale)
-    : name(name), tag(tag), id(id), texture(texture), textureRect(texture_rect), scaleScalar(scale)
-{
-    vertices.setPrimitiveType(sf::PrimitiveType::Triangles);
-    vertices.resize(QUAD_VERTEX_COUNT);
+TileBase::TileBase(const TileData &data, const sf::Vector2i &grid_position, const unsigned int &layer,
+                   const float &scale, const sf::Color &color)
+    : data(&data), gridPosition(grid_position), layer(layer), color(color), scaleScalar(scale)
+{}
+
+TileBase::~TileBase() = default;
 
-    sf::Vector2f pos(grid_position.x * GRID_SIZE * scaleScalar, grid_position.y * GRID_SIZE * scaleScalar);
-    float size = GRID_SIZE * scaleScalar;
+void TileBase::writeQuad(sf::Vertex *quad, const sf::Vector2i &grid_position, const float &scale,
+                         const sf::IntRect &texture_rect, const sf::Color &color)
+{
+    // Made floats first: grid positions may be negative, and the grid size is unsigned.
+    sf::Vector2f pos(static_cast<float>(grid_position.x) * GRID_SIZE * scale,
+                     static_cast<float>(grid_position.y) * GRID_SIZE * scale);
+    float size = GRID_SIZE * scale;
 
     // define the 6 corners of the two triangles
-    vertices[0].position = sf::Vector2f(pos);
-    vertices[1].position = sf::Vector2f(pos.x + size, pos.y);
-    vertices[2].position = sf::Vector2f(pos.x, pos.y + size);
-    vertices[3].position = sf::Vector2f(pos.x, pos.y + size);
-    vertices[4].position = sf::Vector2f(pos.x + size, pos.y);
-    vertices[5].position = sf::Vector2f(pos.x + size, pos.y + size);
+    quad[0].position = sf::Vector2f(pos);
+    quad[1].position = sf::Vector2f(pos.x + size, pos.y);
+    quad[2].position = sf::Vector2f(pos.x, pos.y + size);
+    quad[3].position = sf::Vector2f(pos.x, pos.y + size);
+    quad[4].position = sf::Vector2f(pos.x + size, pos.y);
+    quad[5].position = sf::Vector2f(pos.x + size, pos.y + size);
 
     // define the 6 matching texture coordinates
-    vertices[0].texCoords = sf::Vector2f(textureRect.position);
-    vertices[1].texCoords = sf::Vector2f(textureRect.position.x + textureRect.size.x, textureRect.position.y);
-    vertices[2].texCoords = sf::Vector2f(textureRect.position.x, textureRect.position.y + textureRect.size.y);
-    vertices[3].texCoords = sf::Vector2f(textureRect.position.x, textureRect.position.y + textureRect.size.y);
-    vertices[4].texCoords = sf::Vector2f(textureRect.position.x + textureRect.size.x, textureRect.position.y);
-    vertices[5].texCoords =
-        sf::Vector2f(textureRect.position.x + textureRect.size.x, textureRect.position.y + textureRect.size.y);
-}
+    quad[0].texCoords = sf::Vector2f(texture_rect.position);
+    quad[1].texCoords = sf::Vector2f(texture_rect.position.x + texture_rect.size.x, texture_rect.position.y);
+    quad[2].texCoords = sf::Vector2f(texture_rect.position.x, texture_rect.position.y + texture_rect.size.y);
+    quad[3].texCoords = sf::Vector2f(texture_rect.position.x, texture_rect.position.y + texture_rect.size.y);
+    quad[4].texCoords = sf::Vector2f(texture_rect.position.x + texture_rect.size.x, texture_rect.position.y);
+    quad[5].texCoords =
+        sf::Vector2f(texture_rect.position.x + texture_rect.size.x, texture_rect.position.y + texture_rect.size.y);
 
-TileBase::~TileBase() = default;
+    for (int i = 0; i < QUAD_VERTEX_COUNT; i++)
+        quad[i].color = color;
+}
 
-void TileBase::draw(sf::RenderTarget &target, sf::RenderStates states) const
+const TileData &TileBase::getData() const
 {
-    states.transform *= getTransform();
-    states.texture = &texture;
-    target.draw(vertices, states);
+    return *data;
 }
 
 const std::string &TileBase::getName() const
 {
-    return name;
+    return data->name;
 }
 
 const std::string &TileBase::getTag() const
 {
-    return tag;
+    return data->tag;
 }
 
-const uint64_t &TileBase::getId() const
+const TileId &TileBase::getId() const
 {
-    return id;
+    return data->id;
 }
 
 const sf::Vector2f TileBase::getPosition() const
 {
-    return vertices[0].position;
+    return sf::Vector2f(static_cast<float>(gridPosition.x) * GRID_SIZE * scaleScalar,
+                        static_cast<float>(gridPosition.y) * GRID_SIZE * scaleScalar);
+}
+
+const sf::Vector2i TileBase::getGridPosition() const
+{
+    return gridPosition;
 }
 
-const sf::Vector2u TileBase::getGridPosition() const
+const unsigned int &TileBase::getLayer() const
 {
-    return sf::Vector2u(static_cast<unsigned>(vertices[0].position.x / (GRID_SIZE * scaleScalar)),
-                        static_cast<unsigned>(vertices[0].position.y / (GRID_SIZE * scaleScalar)));
+    return layer;
 }
 
 sf::Color TileBase::getColor() const
 {
-    return vertices[0].color;
+    return color;
 }
 
 const sf::FloatRect TileBase::getGlobalBounds() const
 {
     sf::FloatRect global_bounds;
-    global_bounds.position = vertices[0].position;
+    global_bounds.position = getPosition();
     global_bounds.size = sf::Vector2f(GRID_SIZE * scaleScalar, GRID_SIZE * scaleScalar);
 
     return global_bounds;
@@ -80,42 +89,8 @@ const sf::FloatRect TileBase::getGlobalBounds() const
 
 const sf::Vector2f TileBase::getCenter() const
 {
-    return sf::Vector2f(vertices[0].position.x + static_cast<float>(GRID_SIZE * scaleScalar) / 2.f,
-                        vertices[0].position.y + static_cast<float>(GRID_SIZE * scaleScalar) / 2.f);
-}
+    const sf::Vector2f position = getPosition();
 
-const sf::VertexArray &TileBase::getVertexArray() const
-{
-    return vertices;
-}
-
-void TileBase::setPosition(const sf::Vector2f &position)
-{
-    float size = GRID_SIZE * scaleScalar;
-
-    vertices[0].position = sf::Vector2f(position);
-    vertices[1].position = sf::Vector2f(position.x + size, position.y);
-    vertices[2].position = sf::Vector2f(position.x, position.y + size);
-    vertices[3].position = sf::Vector2f(position.x, position.y + size);
-    vertices[4].position = sf::Vector2f(position.x + size, position.y);
-    vertices[5].position = sf::Vector2f(position.x + size, position.y + size);
-}
-
-void TileBase::setGridPosition(const sf::Vector2u &position)
-{
-    sf::Vector2f pos(position.x * GRID_SIZE * scaleScalar, position.y * GRID_SIZE * scaleScalar);
-    float size = GRID_SIZE * scaleScalar;
-
-    vertices[0].position = sf::Vector2f(pos);
-    vertices[1].position = sf::Vector2f(pos.x + size, pos.y);
-    vertices[2].position = sf::Vector2f(pos.x, pos.y + size);
-    vertices[3].position = sf::Vector2f(pos.x, pos.y + size);
-    vertices[4].position = sf::Vector2f(pos.x + size, pos.y);
-    vertices[5].position = sf::Vector2f(pos.x + size, pos.y + size);
-}
-
-void TileBase::setColor(const sf::Color &color)
-{
-    for (int i = 0; i < QUAD_VERTEX_COUNT; i++)
-        vertices[i].color = color;
+    return sf::Vector2f(position.x + static_cast<float>(GRID_SIZE * scaleScalar) / 2.f,
+                        position.y + static_cast<float>(GRID_SIZE * scaleScalar) / 2.f);
 }
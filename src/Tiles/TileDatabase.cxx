@@ -11,30 +11,59 @@ TileDatabase::~TileDatabase() = default;
 void TileDatabase::insert(const std::string &tag, const std::string &name, const int &rect_index_x,
                           const int &rect_index_y, const int &size_in_pixels)
 {
-    db[tag] = TileData{
-        tag, hash_function(tag), name,
+    auto it = tagIndex.find(tag);
+    TileId id = it != tagIndex.end() ? it->second : static_cast<TileId>(tiles.size());
+
+    TileData data{
+        tag, id, hash_function(tag), name,
         sf::IntRect({rect_index_x * size_in_pixels, rect_index_y * size_in_pixels}, {size_in_pixels, size_in_pixels}),
         size_in_pixels};
-}
 
-const TileData TileDatabase::getByTag(const std::string &tag)
-{
-    try
+    if (it != tagIndex.end())
     {
-        return db.at(tag);
+        tiles[id] = std::move(data);
+        return;
     }
-    catch (std::out_of_range &)
-    {}
 
-    return db.at("unknown");
+    tagIndex.emplace(tag, id);
+    hashIndex.emplace(data.hash, id);
+    tiles.push_back(std::move(data));
 }
 
-const TileData TileDatabase::getById(const uint64_t &id)
+const TileData &TileDatabase::getByTag(const std::string &tag) const
 {
-    auto it = std::find_if(db.begin(), db.end(), [&](auto &pair) { return pair.second.id == id; });
+    return tiles[getIdByTag(tag)];
+}
 
-    if (it != db.end())
+const TileId TileDatabase::getIdByTag(const std::string &tag) const
+{
+    auto it = tagIndex.find(tag);
+
+    if (it != tagIndex.end())
         return it->second;
 
-    return db.at("unknown");
+    return UNKNOWN_TILE_ID;
+}
+
+const TileData &TileDatabase::getById(const TileId &id) const
+{
+    if (id < tiles.size())
+        return tiles[id];
+
+    return tiles[UNKNOWN_TILE_ID];
+}
+
+const TileData &TileDatabase::getByHash(const uint64_t &hash) const
+{
+    auto it = hashIndex.find(hash);
+
+    if (it != hashIndex.end())
+        return tiles[it->second];
+
+    return tiles[UNKNOWN_TILE_ID];
+}
+
+const size_t TileDatabase::getCount() const
+{
+    return tiles.size();
 }
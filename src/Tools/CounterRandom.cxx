@@ -0,0 +1,26 @@
+#include "Tools/CounterRandom.hxx"
+#include "stdafx.hxx"
+
+CounterRandom::CounterRandom(const long long int &seed)
+{
+    uint64_t tmp;
+    std::memcpy(&tmp, &seed, sizeof(tmp)); // Interpret signed as unsigned
+
+    // SplitMix64, so nearby seeds still get unrelated keys.
+    tmp += 0x9E3779B97F4A7C15ull;
+    tmp = (tmp ^ (tmp >> 30)) * 0xBF58476D1CE4E5B9ull;
+    tmp = (tmp ^ (tmp >> 27)) * 0x94D049BB133111EBull;
+    tmp ^= tmp >> 31;
+
+    key0 = static_cast<uint32_t>(tmp);
+    key1 = static_cast<uint32_t>(tmp >> 32);
+}
+
+CounterRandom::~CounterRandom() = default;
+
+void CounterRandom::fillRow(const int x, const int y, const unsigned int count, const uint32_t channel,
+                            float *values) const
+{
+    for (unsigned int i = 0; i < count; i++)
+        values[i] = getFloat(x + static_cast<int>(i), y, channel);
+}
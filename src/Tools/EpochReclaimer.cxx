@@ -0,0 +1,98 @@
+#include "Tools/EpochReclaimer.hxx"
+#include "stdafx.hxx"
+
+/* GUARD ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ */
+
+EpochReclaimer::Guard::Guard(const EpochReclaimer &reclaimer) : owner(&reclaimer)
+{
+    // The epoch may advance between reading it and being counted in it, in which case the count would land in the
+    // wrong parity, so the reader only settles once the epoch it counted itself in is still the current one.
+    while (true)
+    {
+        epoch = reclaimer.epoch.load();
+        reclaimer.active[epoch & 1].fetch_add(1);
+
+        if (reclaimer.epoch.load() == epoch)
+            return;
+
+        reclaimer.active[epoch & 1].fetch_sub(1);
+    }
+}
+
+EpochReclaimer::Guard::Guard(Guard &&other) noexcept : owner(other.owner), epoch(other.epoch)
+{
+    other.owner = nullptr;
+}
+
+EpochReclaimer::Guard::~Guard()
+{
+    if (owner)
+        owner->active[epoch & 1].fetch_sub(1);
+}
+
+/* PRIVATE METHODS ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ */
+
+void EpochReclaimer::collect()
+{
+    // Readers can only be pinned in the current epoch or the one before, so once the previous one is empty the epoch
+    // may advance. Twice at most per call: the second time, the readers of the epoch that was current are needed
+    // gone too.
+    for (int i = 0; i < 2; i++)
+    {
+        const uint64_t current = epoch.load();
+
+        if (active[(current + 1) & 1].load() != 0)
+            break;
+
+        epoch.store(current + 1);
+    }
+
+    const uint64_t current = epoch.load();
+
+    // Objects are retired in epoch order, so the ones that can go are at the front.
+    size_t count = 0;
+    while (count < retired.size() && retired[count].epoch + 2 <= current)
+        count++;
+
+    for (size_t i = 0; i < count; i++)
+        retired[i].deleter();
+
+    retired.erase(retired.begin(), retired.begin() + count);
+}
+
+/* CONSTRUCTOR AND DESTRUCTOR +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ */
+
+EpochReclaimer::EpochReclaimer() : epoch(0)
+{
+    active[0].store(0);
+    active[1].store(0);
+}
+
+EpochReclaimer::~EpochReclaimer()
+{
+    for (Retired &object : retired)
+        object.deleter();
+}
+
+/* PUBLIC METHODS +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ */
+
+EpochReclaimer::Guard EpochReclaimer::pin() const
+{
+    return Guard(*this);
+}
+
+void EpochReclaimer::retire(std::function<void()> deleter)
+{
+    std::lock_guard<std::mutex> lock(retiredMutex);
+
+    retired.push_back({epoch.load(), std::move(deleter)});
+    collect();
+}
+
+void EpochReclaimer::reclaim()
+{
+    std::unique_lock<std::mutex> lock(retiredMutex, std::try_to_lock);
+
+    if (lock.owns_lock())
+        collect();
+}
@@ -0,0 +1,31 @@
+#include "Tools/NoiseMap.hxx"
+#include "stdafx.hxx"
+
+NoiseMap::NoiseMap() : width(0), height(0)
+{}
+
+NoiseMap::NoiseMap(const unsigned int &width, const unsigned int &height, const float &value)
+    : width(width), height(height), values(static_cast<size_t>(width) * height, value)
+{}
+
+NoiseMap::~NoiseMap() = default;
+
+const float *NoiseMap::getData() const
+{
+    return values.data();
+}
+
+const unsigned int NoiseMap::getWidth() const
+{
+    return width;
+}
+
+const unsigned int NoiseMap::getHeight() const
+{
+    return height;
+}
+
+const unsigned int NoiseMap::getStride() const
+{
+    return width;
+}
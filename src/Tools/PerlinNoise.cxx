@@ -1,19 +1,157 @@
 #include "Tools/PerlinNoise.hxx"
 #include "stdafx.hxx"
 
-float PerlinNoise::fade(float t)
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define PERLIN_NOISE_AVX2 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define PERLIN_NOISE_TARGET_AVX2
+#else
+#define PERLIN_NOISE_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+#ifdef PERLIN_NOISE_AVX2
+
+/**
+ * @brief Checks once if the CPU and the OS support AVX2.
+ */
+static const bool hasAvx2()
+{
+#ifdef _MSC_VER
+    static const bool supported = []() {
+        int info[4];
+
+        __cpuid(info, 0);
+        if (info[0] < 7)
+            return false;
+
+        // AVX needs the OS to save the YMM registers (OSXSAVE, with XMM and YMM state enabled).
+        __cpuid(info, 1);
+        if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0 || (_xgetbv(0) & 6) != 6)
+            return false;
+
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+    }();
+#else
+    static const bool supported = __builtin_cpu_supports("avx2");
+#endif
+
+    return supported;
+}
+
+/**
+ * @brief Computes the gradients of 8 corners, like `PerlinNoise::grad`.
+ */
+PERLIN_NOISE_TARGET_AVX2 static inline __m256 grad8(const __m256i hash, const __m256 x, const __m256 y)
+{
+    const __m256i h_lt_2 = _mm256_cmpeq_epi32(_mm256_and_si256(hash, _mm256_set1_epi32(2)), _mm256_setzero_si256());
+
+    const __m256 u = _mm256_blendv_ps(y, x, _mm256_castsi256_ps(h_lt_2));
+    const __m256 v = _mm256_blendv_ps(x, y, _mm256_castsi256_ps(h_lt_2));
+
+    // Bit 0 flips the sign of u and bit 1 the sign of v, exactly like the scalar negations.
+    const __m256 u_sign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(hash, _mm256_set1_epi32(1)), 31));
+    const __m256 v_sign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(hash, _mm256_set1_epi32(2)), 30));
+
+    return _mm256_add_ps(_mm256_xor_ps(u, u_sign), _mm256_xor_ps(v, v_sign));
+}
+
+/**
+ * @brief Fades 8 values, like `PerlinNoise::fade`.
+ */
+PERLIN_NOISE_TARGET_AVX2 static inline __m256 fade8(const __m256 t)
+{
+    const __m256 inner = _mm256_add_ps(
+        _mm256_mul_ps(t, _mm256_sub_ps(_mm256_mul_ps(t, _mm256_set1_ps(6.f)), _mm256_set1_ps(15.f))),
+        _mm256_set1_ps(10.f));
+
+    return _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(t, t), t), inner);
+}
+
+/**
+ * @brief Interpolates 8 pairs of values, like `PerlinNoise::lerp`.
+ */
+PERLIN_NOISE_TARGET_AVX2 static inline __m256 lerp8(const __m256 a, const __m256 b, const __m256 t)
+{
+    return _mm256_add_ps(a, _mm256_mul_ps(t, _mm256_sub_ps(b, a)));
+}
+
+/**
+ * @brief AVX2 version of `PerlinNoise::accumulateRow`, for the first `count - count % 8` samples.
+ *
+ * Every operation mirrors the scalar code in the same order, without fused multiply-adds, so results are identical.
+ */
+PERLIN_NOISE_TARGET_AVX2 static void accumulateRowAvx2(const int *permutation, const float x, const float y,
+                                                       const unsigned int count, const float scale, const Wave &wave,
+                                                       const sf::Vector2f &offset, float *values)
+{
+    // The row shares its y-coordinate, so its part of the lattice is computed once.
+    const float sample_y = (y * scale + offset.y) * wave.frequency + wave.seed;
+    const float floor_y = std::floor(sample_y);
+
+    const float frac_y = sample_y - floor_y;
+
+    const __m256i Y = _mm256_set1_epi32(static_cast<int>(floor_y) & 255);
+    const __m256 yf = _mm256_set1_ps(frac_y);
+    const __m256 yf_1 = _mm256_set1_ps(frac_y - 1);
+    const __m256 v = _mm256_set1_ps(frac_y * frac_y * frac_y * (frac_y * (frac_y * 6 - 15) + 10));
+
+    const __m256 lanes = _mm256_setr_ps(0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f);
+    const __m256 one = _mm256_set1_ps(1.f);
+
+    for (unsigned int i = 0; i + 8 <= count; i += 8)
+    {
+        const __m256 xs = _mm256_add_ps(_mm256_set1_ps(x), _mm256_add_ps(_mm256_set1_ps(static_cast<float>(i)), lanes));
+
+        const __m256 sample_x = _mm256_add_ps(
+            _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(xs, _mm256_set1_ps(scale)), _mm256_set1_ps(offset.x)),
+                          _mm256_set1_ps(wave.frequency)),
+            _mm256_set1_ps(wave.seed));
+
+        const __m256 floor_x = _mm256_floor_ps(sample_x);
+        const __m256i X = _mm256_and_si256(_mm256_cvttps_epi32(floor_x), _mm256_set1_epi32(255));
+        const __m256 xf = _mm256_sub_ps(sample_x, floor_x);
+        const __m256 xf_1 = _mm256_sub_ps(xf, one);
+        const __m256 u = fade8(xf);
+
+        const __m256i p_x = _mm256_i32gather_epi32(permutation, X, 4);
+        const __m256i p_x1 = _mm256_i32gather_epi32(permutation, _mm256_add_epi32(X, _mm256_set1_epi32(1)), 4);
+
+        const __m256i aa = _mm256_i32gather_epi32(permutation, _mm256_add_epi32(p_x, Y), 4);
+        const __m256i ab =
+            _mm256_i32gather_epi32(permutation, _mm256_add_epi32(_mm256_add_epi32(p_x, Y), _mm256_set1_epi32(1)), 4);
+        const __m256i ba = _mm256_i32gather_epi32(permutation, _mm256_add_epi32(p_x1, Y), 4);
+        const __m256i bb =
+            _mm256_i32gather_epi32(permutation, _mm256_add_epi32(_mm256_add_epi32(p_x1, Y), _mm256_set1_epi32(1)), 4);
+
+        const __m256 result = lerp8(lerp8(grad8(aa, xf, yf), grad8(ba, xf_1, yf), u),
+                                    lerp8(grad8(ab, xf, yf_1), grad8(bb, xf_1, yf_1), u), v);
+
+        const __m256 noise = _mm256_div_ps(_mm256_add_ps(result, one), _mm256_set1_ps(2.f));
+
+        _mm256_storeu_ps(values + i, _mm256_add_ps(_mm256_loadu_ps(values + i),
+                                                   _mm256_mul_ps(_mm256_set1_ps(wave.amplitude), noise)));
+    }
+}
+
+#endif
+
+float PerlinNoise::fade(float t) const
 {
     // Fade function: 6t^5 - 15t^4 + 10t^3
     return t * t * t * (t * (t * 6 - 15) + 10);
 }
 
-float PerlinNoise::lerp(float a, float b, float t)
+float PerlinNoise::lerp(float a, float b, float t) const
 {
     // Linear interpolation
     return a + t * (b - a);
 }
 
-float PerlinNoise::grad(int hash, float x, float y)
+float PerlinNoise::grad(int hash, float x, float y) const
 {
     // Calculate gradient based on hash value
     int h = hash & 3; // Take the last 2 bits of the hash
@@ -22,7 +160,7 @@ float PerlinNoise::grad(int hash, float x, float y)
     return ((h & 1) == 0 ? u : -u) + ((h & 2) == 0 ? v : -v);
 }
 
-float PerlinNoise::noise(float x, float y)
+float PerlinNoise::noise(float x, float y) const
 {
     // Find the unit grid cell containing the point
     int X = static_cast<int>(std::floor(x)) & 255;
@@ -73,39 +211,80 @@ PerlinNoise::PerlinNoise(const unsigned int &seed)
 PerlinNoise::~PerlinNoise()
 {}
 
-const NoiseMap PerlinNoise::generateNoiseMap(const unsigned int &width, const unsigned int &height, const float &scale,
-                                             const std::vector<Wave> &waves, const sf::Vector2f &offset)
+void PerlinNoise::accumulateRow(const float &x, const float &y, const unsigned int &count, const float &scale,
+                                const Wave &wave, const sf::Vector2f &offset, float *values) const
 {
-    NoiseMap noise_map;
+    unsigned int done = 0;
 
-    // Initialize the noise map with the correct dimensions
-    noise_map.resize(width, std::vector<float>(height, 0.0f));
+#ifdef PERLIN_NOISE_AVX2
+    if (hasAvx2())
+    {
+        accumulateRowAvx2(permutation.data(), x, y, count, scale, wave, offset, values);
+        done = count - count % 8;
+    }
+#endif
 
-    // sf::Image image({width, height});
+    const float sample_pos_y = y * scale + offset.y;
 
-    for (unsigned int y = 0; y < height; y++)
+    for (unsigned int i = done; i < count; i++)
+    {
+        const float sample_pos_x = (x + static_cast<float>(i)) * scale + offset.x;
+
+        values[i] += wave.amplitude *
+                     noise(sample_pos_x * wave.frequency + wave.seed, sample_pos_y * wave.frequency + wave.seed);
+    }
+}
+
+const float PerlinNoise::sample(const float &x, const float &y, const float &scale, const std::vector<Wave> &waves,
+                               const sf::Vector2f &offset) const
+{
+    float sample_pos_x = x * scale + offset.x;
+    float sample_pos_y = y * scale + offset.y;
+
+    float value = 0.f;
+    float normalization = 0.f;
+
+    for (auto &wave : waves)
+    {
+        value += wave.amplitude *
+                 noise(sample_pos_x * wave.frequency + wave.seed, sample_pos_y * wave.frequency + wave.seed);
+        normalization += wave.amplitude;
+    }
+
+    if (normalization == 0)
+        normalization = 1.f; // Prevent division by zero
+
+    // Normalize the noise value
+    return value / normalization;
+}
+
+void PerlinNoise::sampleRow(const float &x, const float &y, const unsigned int &count, const float &scale,
+                            const std::vector<Wave> &waves, const sf::Vector2f &offset, float *values) const
+{
+    std::fill(values, values + count, 0.f);
+
+    float normalization = 0.f;
+
+    for (auto &wave : waves)
     {
-        for (unsigned int x = 0; x < width; x++)
-        {
-            float sample_pos_x = static_cast<float>(x) * scale + offset.x;
-            float sample_pos_y = static_cast<float>(y) * scale + offset.y;
-
-            float normalization = 0.f;
-
-            for (auto &wave : waves)
-            {
-                noise_map[x][y] += wave.amplitude * noise(sample_pos_x * wave.frequency + wave.seed,
-                                                          sample_pos_y * wave.frequency + wave.seed);
-                normalization += wave.amplitude;
-            }
-
-            if (normalization == 0)
-                normalization = 1.f; // Prevent division by zero
-
-            // Normalize the noise value
-            noise_map[x][y] /= normalization;
-        }
+        accumulateRow(x, y, count, scale, wave, offset, values);
+        normalization += wave.amplitude;
     }
 
+    if (normalization == 0)
+        normalization = 1.f; // Prevent division by zero
+
+    for (unsigned int i = 0; i < count; i++)
+        values[i] /= normalization;
+}
+
+const NoiseMap PerlinNoise::generateNoiseMap(const unsigned int &width, const unsigned int &height, const float &scale,
+                                             const std::vector<Wave> &waves, const sf::Vector2f &offset) const
+{
+    NoiseMap noise_map(width, height);
+
+    for (unsigned int y = 0; y < height; y++)
+        sampleRow(0.f, static_cast<float>(y), width, scale, waves, offset, noise_map.getRow(y));
+
     return noise_map;
-}
\ No newline at end of file
+}
@@ -0,0 +1,177 @@
+#include "Tools/Profiler.hxx"
+#include "stdafx.hxx"
+
+/* PRIVATE TYPES ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ */
+
+struct Profiler::Registry
+{
+    std::mutex mutex;                             ///< Guards the registry.
+    std::vector<std::unique_ptr<Buffer>> buffers; ///< The buffers of every thread that ever recorded a zone.
+    std::vector<Buffer *> free;                   ///< The buffers of the threads that exited.
+    std::map<uint32_t, std::string> threadNames;  ///< The names of the threads, by thread number.
+    uint32_t nextThread = 1;                      ///< The number of the next thread.
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now(); ///< When profiling started.
+};
+
+struct Profiler::ThreadSlot
+{
+    Buffer *buffer = nullptr; ///< The buffer of the thread, or `nullptr` until it records a zone.
+    uint32_t thread = 0;      ///< The number of the thread.
+
+    ~ThreadSlot()
+    {
+        if (!buffer)
+            return;
+
+        Registry &registry = getRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.free.push_back(buffer);
+    }
+};
+
+/* ZONE +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ */
+
+Profiler::Zone::Zone(const char *name) : name(name), start(now())
+{}
+
+Profiler::Zone::~Zone()
+{
+    record(name, start, now());
+}
+
+/* PRIVATE METHODS ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ */
+
+Profiler::Registry &Profiler::getRegistry()
+{
+    // Never destroyed: threads still running at exit may hand their buffer back after static destructors ran.
+    static Registry *registry = new Registry();
+    return *registry;
+}
+
+Profiler::ThreadSlot &Profiler::getThreadSlot()
+{
+    thread_local ThreadSlot slot;
+
+    if (slot.thread == 0)
+    {
+        Registry &registry = getRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        slot.thread = registry.nextThread++;
+    }
+
+    return slot;
+}
+
+const uint64_t Profiler::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+                                                                getRegistry().start)
+        .count();
+}
+
+void Profiler::record(const char *name, const uint64_t start, const uint64_t end)
+{
+    ThreadSlot &slot = getThreadSlot();
+
+    if (!slot.buffer)
+    {
+        Registry &registry = getRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+
+        if (registry.free.empty())
+        {
+            registry.buffers.push_back(std::make_unique<Buffer>());
+            registry.buffers.back()->events.resize(PROFILER_BUFFER_CAPACITY);
+            registry.buffers.back()->count = 0;
+            slot.buffer = registry.buffers.back().get();
+        }
+        else
+        {
+            slot.buffer = registry.free.back();
+            registry.free.pop_back();
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(slot.buffer->mutex);
+    slot.buffer->events[slot.buffer->count++ % PROFILER_BUFFER_CAPACITY] = {name, start, end - start, slot.thread};
+}
+
+/* PUBLIC METHODS +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ */
+
+void Profiler::setThreadName(const std::string &name)
+{
+    const uint32_t thread = getThreadSlot().thread;
+
+    Registry &registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.threadNames[thread] = name;
+}
+
+const size_t Profiler::exportTrace(const std::filesystem::path &path)
+{
+    std::vector<Event> events;
+    std::map<uint32_t, std::string> thread_names;
+
+    {
+        Registry &registry = getRegistry();
+        std::lock_guard<std::mutex> registry_lock(registry.mutex);
+
+        thread_names = registry.threadNames;
+
+        for (auto &buffer : registry.buffers)
+        {
+            std::lock_guard<std::mutex> lock(buffer->mutex);
+            const size_t size = std::min<uint64_t>(buffer->count, PROFILER_BUFFER_CAPACITY);
+            events.insert(events.end(), buffer->events.begin(), buffer->events.begin() + size);
+        }
+    }
+
+    std::ofstream out(path);
+
+    if (!out.is_open())
+        throw std::runtime_error(_("Failed to open trace file: ") + path.string());
+
+    auto write_string = [&out](const std::string &str) {
+        out << '"';
+        for (const char c : str)
+        {
+            if (c == '"' || c == '\\')
+                out << '\\';
+            out << c;
+        }
+        out << '"';
+    };
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    bool first = true;
+
+    for (const auto &[thread, name] : thread_names)
+    {
+        out << (first ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread
+            << ",\"args\":{\"name\":";
+        write_string(name);
+        out << "}}";
+        first = false;
+    }
+
+    // Chrome traces count in microseconds.
+    out << std::fixed << std::setprecision(3);
+
+    for (const Event &event : events)
+    {
+        out << (first ? "\n" : ",\n") << "{\"name\":";
+        write_string(event.name);
+        out << ",\"ph\":\"X\",\"ts\":" << event.start / 1000.0 << ",\"dur\":" << event.duration / 1000.0
+            << ",\"pid\":1,\"tid\":" << event.thread << "}";
+        first = false;
+    }
+
+    out << "\n]}\n";
+
+    if (!out)
+        throw std::runtime_error(_("Failed to write trace file: ") + path.string());
+
+    return events.size();
+}
@@ -0,0 +1,55 @@
+#include "Tools/ThreadPool.hxx"
+#include "stdafx.hxx"
+
+/* PRIVATE METHODS ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ */
+
+void ThreadPool::work()
+{
+    PROFILE_THREAD(name);
+
+    while (true)
+    {
+        std::function<void()> task;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this] { return !running || !tasks.empty(); });
+
+            if (tasks.empty())
+                return;
+
+            task = std::move(tasks.front());
+            tasks.pop();
+        }
+
+        task();
+    }
+}
+
+/* CONSTRUCTOR AND DESTRUCTOR +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ */
+
+ThreadPool::ThreadPool(const unsigned int worker_count, const std::string &name) : running(true), name(name)
+{
+    for (unsigned int i = 0; i < std::max(worker_count, 1u); i++)
+        workers.emplace_back(&ThreadPool::work, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+    }
+
+    condition.notify_all();
+
+    for (auto &worker : workers)
+        worker.join();
+}
+
+/* PUBLIC METHODS +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ */
+
+const size_t ThreadPool::getWorkerCount() const
+{
+    return workers.size();
+}
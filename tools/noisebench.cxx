@@ -0,0 +1,231 @@
+/**
+ * @file noisebench.cxx
+ * @brief Headless tool that times the NoiseMap layout on a noise map the size of the playable area.
+ *
+ * Usage: `pixelminer-noisebench [--runs <n>] [--seed <n>]`
+ *
+ * Generation, a row-order scan and random lookups are timed on a flat `NoiseMap` and on the nested vectors
+ * (`std::vector<std::vector<float>>`, indexed `[x][y]`) it replaced, using the same noise and the same lookup
+ * positions. Each case runs `--runs` times (5 by default) and the best time is reported, so the first touch of the
+ * memory and other noise don't count.
+ */
+
+#include "Map/TerrainGenerator.hxx"
+#include "Tools/NoiseMap.hxx"
+#include "Tools/PerlinNoise.hxx"
+#include "stdafx.hxx"
+
+/**
+ * @brief The noise map layout `NoiseMap` replaced, indexed `[x][y]`.
+ */
+using NestedNoiseMap = std::vector<std::vector<float>>;
+
+/**
+ * @struct BenchOptions
+ * @brief The options of a benchmark run, as given on the command line.
+ */
+struct BenchOptions
+{
+    unsigned int runs = 5;    ///< Amount of times each case runs.
+    unsigned int seed = 1337; ///< Seed of the noise and of the lookup positions.
+};
+
+/**
+ * @brief Parses the command line.
+ *
+ * @param argc The amount of arguments.
+ * @param argv The arguments.
+ * @param options The options to fill.
+ * @return `true` if the command line is valid, `false` otherwise.
+ */
+static const bool parseOptions(int argc, char **argv, BenchOptions &options)
+{
+    try
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            const std::string arg = argv[i];
+
+            if (arg == "--runs" && i + 1 < argc)
+                options.runs = static_cast<unsigned int>(std::stoul(argv[++i]));
+            else if (arg == "--seed" && i + 1 < argc)
+                options.seed = static_cast<unsigned int>(std::stoul(argv[++i]));
+            else
+                return false;
+        }
+    }
+    catch (std::exception &)
+    {
+        return false;
+    }
+
+    return options.runs > 0;
+}
+
+/**
+ * @brief Runs a case several times and keeps the best time.
+ *
+ * @param runs The amount of times to run the case.
+ * @param run The case. Returns a checksum, so the work can't be optimized out.
+ * @param checksum Set to the checksum of the last run.
+ * @return The best time (in milliseconds).
+ */
+static const double timeBest(const unsigned int runs, const std::function<double()> &run, double &checksum)
+{
+    double best = std::numeric_limits<double>::max();
+
+    for (unsigned int i = 0; i < runs; i++)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        checksum = run();
+        const auto end = std::chrono::steady_clock::now();
+
+        best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+    }
+
+    return best;
+}
+
+/**
+ * @brief Generates nested noise maps the way `PerlinNoise::generateNoiseMap` did before `NoiseMap`: a row at a
+ * time, each value stored to a different column vector.
+ *
+ * @param noise The noise generator.
+ * @param width The width of the map.
+ * @param height The height of the map.
+ * @param scale The scale of the noise.
+ * @param waves The waves to combine.
+ * @param offset The offset of the noise.
+ * @return The nested noise map.
+ */
+static NestedNoiseMap generateNested(const PerlinNoise &noise, const unsigned int width, const unsigned int height,
+                                     const float scale, const std::vector<Wave> &waves, const sf::Vector2f &offset)
+{
+    NestedNoiseMap map(width, std::vector<float>(height));
+    std::vector<float> row(width);
+
+    for (unsigned int y = 0; y < height; y++)
+    {
+        noise.sampleRow(0.f, static_cast<float>(y), width, scale, waves, offset, row.data());
+
+        for (unsigned int x = 0; x < width; x++)
+            map[x][y] = row[x];
+    }
+
+    return map;
+}
+
+int main(int argc, char **argv)
+{
+    BenchOptions options;
+
+    if (!parseOptions(argc, argv, options))
+    {
+        std::cerr << "Usage: pixelminer-noisebench [--runs <n>] [--seed <n>]" << std::endl;
+        return 1;
+    }
+
+    const unsigned int WIDTH = MAX_WORLD_GRID_SIZE.x;
+    const unsigned int HEIGHT = MAX_WORLD_GRID_SIZE.y;
+    const size_t COUNT = static_cast<size_t>(WIDTH) * HEIGHT;
+
+    // The moisture noise of the terrain generator: two waves.
+    const PerlinNoise noise(options.seed);
+    const std::vector<Wave> waves = {{622.f, .06f, 6.f}, {344.f, .02f, 2.f}};
+    const float scale = .009f;
+    const sf::Vector2f offset = {10.f, 10.f};
+
+    std::mt19937 rng(options.seed);
+    std::uniform_int_distribution<unsigned int> x_dist(0, WIDTH - 1), y_dist(0, HEIGHT - 1);
+    std::vector<sf::Vector2u> positions(COUNT);
+
+    for (sf::Vector2u &position : positions)
+        position = {x_dist(rng), y_dist(rng)};
+
+    struct Result
+    {
+        std::string name; ///< The name of the case.
+        double nested;    ///< The best time of the nested vectors (in milliseconds).
+        double flat;      ///< The best time of the flat map (in milliseconds).
+    };
+
+    std::vector<Result> results;
+    double nested_sum = 0.0, flat_sum = 0.0;
+
+    // Each map is built within the timer, so allocating and releasing each layout counts too.
+    auto nested_generation = [&]() {
+        const NestedNoiseMap map = generateNested(noise, WIDTH, HEIGHT, scale, waves, offset);
+        return static_cast<double>(map[WIDTH - 1][HEIGHT - 1]);
+    };
+    auto flat_generation = [&]() {
+        const NoiseMap map = noise.generateNoiseMap(WIDTH, HEIGHT, scale, waves, offset);
+        return static_cast<double>(map(WIDTH - 1, HEIGHT - 1));
+    };
+
+    results.push_back({"generation", timeBest(options.runs, nested_generation, nested_sum),
+                       timeBest(options.runs, flat_generation, flat_sum)});
+
+    const NestedNoiseMap nested = generateNested(noise, WIDTH, HEIGHT, scale, waves, offset);
+    const NoiseMap flat = noise.generateNoiseMap(WIDTH, HEIGHT, scale, waves, offset);
+
+    // The order the noise is generated and read in: a row at a time, x inner.
+    auto nested_scan = [&]() {
+        double sum = 0.0;
+        for (unsigned int y = 0; y < HEIGHT; y++)
+        {
+            for (unsigned int x = 0; x < WIDTH; x++)
+                sum += nested[x][y];
+        }
+        return sum;
+    };
+    auto flat_scan = [&]() {
+        double sum = 0.0;
+        for (unsigned int y = 0; y < HEIGHT; y++)
+        {
+            const float *row = flat.getRow(y);
+            for (unsigned int x = 0; x < WIDTH; x++)
+                sum += row[x];
+        }
+        return sum;
+    };
+
+    results.push_back({"row scan", timeBest(options.runs, nested_scan, nested_sum),
+                       timeBest(options.runs, flat_scan, flat_sum)});
+
+    // Both layouts add the same values in the same order, so the sums only differ if the noise does.
+    if (nested_sum != flat_sum)
+    {
+        std::cerr << "The layouts hold different noise." << std::endl;
+        return 1;
+    }
+
+    auto nested_lookup = [&]() {
+        double sum = 0.0;
+        for (const sf::Vector2u &position : positions)
+            sum += nested[position.x][position.y];
+        return sum;
+    };
+    auto flat_lookup = [&]() {
+        double sum = 0.0;
+        for (const sf::Vector2u &position : positions)
+            sum += flat(position.x, position.y);
+        return sum;
+    };
+
+    results.push_back({"random lookup", timeBest(options.runs, nested_lookup, nested_sum),
+                       timeBest(options.runs, flat_lookup, flat_sum)});
+
+    std::cout << WIDTH << "x" << HEIGHT << " noise map, " << waves.size() << " waves, best of " << options.runs
+              << " runs (checksum " << std::fixed << std::setprecision(3) << flat_sum << ")" << std::endl
+              << std::left << std::setw(16) << "case" << std::right << std::setw(14) << "nested (ms)" << std::setw(14)
+              << "flat (ms)" << std::setw(10) << "speedup" << std::endl;
+
+    for (const Result &result : results)
+    {
+        std::cout << std::left << std::setw(16) << result.name << std::right << std::setprecision(2) << std::setw(14)
+                  << result.nested << std::setw(14) << result.flat << std::setw(9)
+                  << result.nested / std::max(result.flat, 1e-9) << "x" << std::endl;
+    }
+
+    return 0;
+}
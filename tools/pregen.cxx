@@ -0,0 +1,288 @@
+/**
+ * @file pregen.cxx
+ * @brief Headless tool that generates and saves the regions of a new world, without opening a window.
+ *
+ * Usage: `pixelminer-pregen <world name> <seed> [<min x> <min y> <max x> <max y>] [--threads <n>] [--pack <file>]`
+ *
+ * The region range is inclusive, may be negative, and defaults to the playable area (see `MAX_REGIONS`). Each region
+ * is generated, packed and written by a single worker, then released, so memory only grows with the amount of
+ * workers. The world is written to the maps folder like a world saved by the game. The tile ID table is saved before
+ * every region that adds to it, and the metadata after every region, so an interrupted run leaves a world the game
+ * can open, which generates the regions that were never written.
+ */
+
+#include "Engine/Configuration.hxx"
+#include "Engine/Languages.hxx"
+#include "Engine/ResourcePack.hxx"
+#include "Map/Metadata.hxx"
+#include "Map/RegionFile.hxx"
+#include "Map/TerrainGenerator.hxx"
+#include "Map/TileIdTable.hxx"
+#include "Tools/Logger.hxx"
+#include "Tools/ThreadPool.hxx"
+#include "stdafx.hxx"
+
+/**
+ * @struct PregenOptions
+ * @brief The options of a pre-generation run, as given on the command line.
+ */
+struct PregenOptions
+{
+    std::string worldName;                    ///< Name of the world folder to create.
+    long int seed = 0;                        ///< Seed of the world.
+    sf::Vector2i minRegion = {0, 0};          ///< First region to generate (inclusive).
+    sf::Vector2i maxRegion = {-1, -1};        ///< Last region to generate (inclusive).
+    unsigned int threadCount = 0;             ///< Amount of workers (0 for every hardware thread).
+    std::string packFilename = "Vanilla.zip"; ///< Resource pack holding the tile database and biome rules.
+};
+
+/**
+ * @brief Parses the command line.
+ *
+ * @param argc The amount of arguments.
+ * @param argv The arguments.
+ * @param options The options to fill.
+ * @return `true` if the command line is valid, `false` otherwise.
+ */
+static const bool parseOptions(int argc, char **argv, PregenOptions &options)
+{
+    std::vector<std::string> positional;
+
+    try
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            const std::string arg = argv[i];
+
+            if (arg == "--threads" && i + 1 < argc)
+                options.threadCount = static_cast<unsigned int>(std::stoul(argv[++i]));
+            else if (arg == "--pack" && i + 1 < argc)
+                options.packFilename = argv[++i];
+            else
+                positional.push_back(arg);
+        }
+
+        if (positional.size() != 2 && positional.size() != 6)
+            return false;
+
+        options.worldName = positional[0];
+        options.seed = std::stol(positional[1]);
+
+        if (positional.size() == 6)
+        {
+            options.minRegion = {std::stoi(positional[2]), std::stoi(positional[3])};
+            options.maxRegion = {std::stoi(positional[4]), std::stoi(positional[5])};
+        }
+        else
+            options.maxRegion = {static_cast<int>(MAX_REGIONS.x) - 1, static_cast<int>(MAX_REGIONS.y) - 1};
+    }
+    catch (std::exception &)
+    {
+        return false;
+    }
+
+    return !options.worldName.empty() && options.minRegion.x <= options.maxRegion.x &&
+           options.minRegion.y <= options.maxRegion.y;
+}
+
+/**
+ * @brief Builds the metadata of the new world. The player spawns at the center of the generated regions.
+ *
+ * @param options The options of the run.
+ * @return The metadata of the world.
+ */
+static Metadata createMetadata(const PregenOptions &options)
+{
+    const int REGION_WIDTH = REGION_SIZE_IN_CHUNKS.x * CHUNK_SIZE_IN_TILES.x;
+    const int REGION_HEIGHT = REGION_SIZE_IN_CHUNKS.y * CHUNK_SIZE_IN_TILES.y;
+
+    Metadata metadata;
+    metadata.metadataVersion = METADATA_VERSION;
+    metadata.gameVersion = GAME_VERSION;
+    metadata.creationDate = std::time(0);
+    metadata.dataPacks.enabled = JArray({"vanilla"});
+    metadata.dataPacks.disabled = JArray({});
+    metadata.dayTime = 300000;
+    metadata.difficulty = "normal";
+    metadata.generatorName = "default";
+    metadata.lastPlayed = -1;
+    metadata.name = options.worldName;
+    metadata.seed = options.seed;
+    metadata.saveMode = "full";
+    metadata.spawnX = (options.minRegion.x + options.maxRegion.x + 1) * REGION_WIDTH / 2;
+    metadata.spawnY = (options.minRegion.y + options.maxRegion.y + 1) * REGION_HEIGHT / 2;
+    metadata.timePlayed = 0;
+
+    return metadata;
+}
+
+/**
+ * @brief Writes the metadata of a world next to its regions.
+ *
+ * @param metadata The metadata to write.
+ * @param path The path to the metadata file.
+ * @return `true` if the metadata was written, `false` otherwise.
+ */
+static const bool writeMetadata(Metadata &metadata, const std::filesystem::path &path)
+{
+    JObject metadata_obj;
+    metadata_obj << metadata;
+
+    std::filesystem::path tmp_path = path;
+    tmp_path += ".tmp";
+
+    std::ofstream file(tmp_path);
+    if (!file.is_open())
+        return false;
+
+    file << JSON::stringify(metadata_obj);
+    file.close();
+
+    std::error_code ec;
+    std::filesystem::rename(tmp_path, path, ec);
+    return !ec;
+}
+
+int main(int argc, char **argv)
+{
+    Logger logger("Pregen");
+    PregenOptions options;
+
+    if (!parseOptions(argc, argv, options))
+    {
+        std::cerr << "Usage: pixelminer-pregen <world name> <seed> [<min x> <min y> <max x> <max y>] "
+                     "[--threads <n>] [--pack <file>]"
+                  << std::endl
+                  << "The playable area spans regions 0 to " << MAX_REGIONS.x - 1 << " (x) and " << MAX_REGIONS.y - 1
+                  << " (y)." << std::endl;
+        return 1;
+    }
+
+    const std::filesystem::path world_path = MAPS_FOLDER + options.worldName;
+
+    if (std::filesystem::exists(world_path))
+    {
+        logger.logError(_("World already exists: ") + world_path.string(), false);
+        return 1;
+    }
+
+    ResourcePack pack;
+    if (!pack.loadData(options.packFilename))
+    {
+        logger.logError(_("Failed to load resource pack: ") + options.packFilename, false);
+        return 1;
+    }
+
+    std::filesystem::create_directories(world_path / "regions");
+
+    std::string msg;
+    Metadata metadata = createMetadata(options);
+    sf::Texture texture_pack;
+    TileIdTable tile_ids;
+
+    ChunkStore chunks;
+    TerrainGenerator generator(msg, metadata, chunks, options.seed, texture_pack, pack.tileDb, pack.biomeRules, 1.f);
+
+    std::vector<sf::Vector2i> region_indexes;
+    for (int x = options.minRegion.x; x <= options.maxRegion.x; x++)
+    {
+        for (int y = options.minRegion.y; y <= options.maxRegion.y; y++)
+            region_indexes.push_back({x, y});
+    }
+
+    const std::filesystem::path table_path = world_path / TILE_ID_TABLE_FILENAME;
+    const std::filesystem::path metadata_path = world_path / "metadata.json";
+    std::mutex table_mutex;
+
+    ThreadPool pool(options.threadCount > 0 ? options.threadCount
+                                            : std::max(std::thread::hardware_concurrency(), 1u));
+
+    logger.logInfo(_("Generating ") + std::to_string(region_indexes.size()) + _(" regions on ") +
+                   std::to_string(pool.getWorkerCount()) + _(" threads..."));
+
+    const auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::future<uintmax_t>> futures;
+    futures.reserve(region_indexes.size());
+
+    for (const sf::Vector2i &region_index : region_indexes)
+    {
+        futures.push_back(pool.enqueue([&, region_index]() -> uintmax_t {
+            generator.generateRegion(region_index);
+
+            const int CHUNK_START_X = region_index.x * static_cast<int>(REGION_SIZE_IN_CHUNKS.x);
+            const int CHUNK_START_Y = region_index.y * static_cast<int>(REGION_SIZE_IN_CHUNKS.y);
+
+            RegionRecords records;
+
+            for (int c_x = CHUNK_START_X; c_x < CHUNK_START_X + static_cast<int>(REGION_SIZE_IN_CHUNKS.x); c_x++)
+            {
+                for (int c_y = CHUNK_START_Y; c_y < CHUNK_START_Y + static_cast<int>(REGION_SIZE_IN_CHUNKS.y); c_y++)
+                {
+                    const sf::Vector2i chunk_index(c_x, c_y);
+
+                    records[RegionFile::getSlot(chunk_index)] =
+                        RegionFile::pack(*chunks.get(chunk_index), pack.tileDb, tile_ids);
+                    chunks.erase(chunk_index);
+                }
+            }
+
+            const std::filesystem::path path = world_path / "regions" /
+                                               ("r." + std::to_string(region_index.x) + "." +
+                                                std::to_string(region_index.y) + ".region");
+
+            // The region references the world IDs it was just given, so the table is saved first. Saves are
+            // serialized, since every worker writes the same file.
+            {
+                std::lock_guard<std::mutex> lock(table_mutex);
+                if (tile_ids.isModified() && !tile_ids.save(table_path))
+                    return 0;
+            }
+
+            if (!RegionFile::write(path, records))
+                return 0;
+
+            return std::filesystem::file_size(path);
+        }));
+    }
+
+    uintmax_t bytes_written = 0;
+    size_t failed = 0;
+
+    for (size_t i = 0; i < futures.size(); i++)
+    {
+        const uintmax_t bytes = futures[i].get();
+
+        bytes_written += bytes;
+        if (bytes == 0)
+            failed++;
+
+        // An interrupted run leaves a world the game can open, which generates the regions that are missing.
+        if (!writeMetadata(metadata, metadata_path))
+        {
+            std::cout << std::endl;
+            logger.logError(_("Failed to write world files: ") + world_path.string(), false);
+            return 1;
+        }
+
+        std::cout << "\r" << _("Generating terrain: ") << (i + 1) * 100 / futures.size() << "%" << std::flush;
+    }
+
+    std::cout << std::endl;
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (failed > 0)
+    {
+        logger.logError(std::to_string(failed) + _(" regions could not be written."), false);
+        return 1;
+    }
+
+    std::ostringstream report;
+    report << std::fixed << std::setprecision(2) << region_indexes.size() << _(" regions in ") << seconds << " s ("
+           << region_indexes.size() / std::max(seconds, 1e-9) << _(" regions/s), ") << bytes_written / 1024.0
+           << _(" KiB written (") << bytes_written / 1024.0 / 1024.0 / std::max(seconds, 1e-9) << " MiB/s).";
+
+    logger.logInfo(report.str());
+    return 0;
+}